@@ -0,0 +1,98 @@
+// Records a blink, laugh or confused animation of RoboEyes and writes it as a clip for
+// RoboEyesClipPlayer.
+//
+//   roboeyes_bake animation name path [screen-width screen-height eye-width eye-height radius mood]
+//
+// animation is blink, laugh or confused, name the array in the written source file, mood
+// default, tired, angry or happy. The eyes open, settle, play the animation and settle again,
+// every 10 ms frame in between goes into the clip. Bake it with the settings of the eyes that
+// will play it, e.g.
+//
+//   roboeyes_bake blink blinkClip blink_clip.h 128 64 36 36 8 default
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "RoboEyes.hpp"
+#include "RoboEyesClip.hpp"
+
+static constexpr unsigned int FRAME_MS = 10;       // 100 fps
+static constexpr unsigned int MAX_FRAMES = 1000;  // give up on eyes that never settle
+
+static bool settle(RoboEyes& eyes, RoboEyesClipWriter* writer) {
+    for (unsigned int frame = 0; frame < MAX_FRAMES; frame++) {
+        roboEyesHostAdvanceMillis(FRAME_MS);
+        eyes.update();
+        if (writer) {
+            writer->addFrame();
+        }
+        if (eyes.isSettled()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4 && argc != 10) {
+        fprintf(stderr, "usage: roboeyes_bake blink|laugh|confused name path [screen-width screen-height eye-width eye-height radius mood]\n");
+        return 1;
+    }
+    const char* animation = argv[1];
+    const int screenWidth = argc > 4 ? atoi(argv[4]) : 128;
+    const int screenHeight = argc > 4 ? atoi(argv[5]) : 64;
+    const int eyeWidth = argc > 4 ? atoi(argv[6]) : EYE_WIDTH;
+    const int eyeHeight = argc > 4 ? atoi(argv[7]) : EYE_HEIGHT;
+    const int radius = argc > 4 ? atoi(argv[8]) : EYE_BORDER_RADIUS;
+    const char* moodName = argc > 4 ? argv[9] : "default";
+
+    static const char* const moods[] = {"default", "tired", "angry", "happy"};
+    int mood = 0;
+    while (mood < 4 && strcmp(moodName, moods[mood]) != 0) {
+        mood++;
+    }
+    const int maxScreen = sizeof(EyeSize) == 1 ? 255 : 65535;  // wider screens need ROBOEYES_LARGE_SCREEN
+    if (mood == 4 || screenWidth < 1 || screenWidth > maxScreen || screenHeight < 1 || eyeWidth < 1 || eyeHeight < 1 || radius < 0) {
+        fprintf(stderr, "invalid size or mood\n");
+        return 1;
+    }
+
+    HostFramebuffer framebuffer(screenWidth, screenHeight);
+    RoboEyes eyes(screenWidth, screenHeight, 1000 / FRAME_MS, roboEyesDisplay(framebuffer));
+    eyes.setWidth(eyeWidth, eyeWidth);
+    eyes.setHeight(eyeHeight, eyeHeight);
+    eyes.setBorderradius(radius, radius);
+    eyes.setMood(mood);
+    eyes.open();
+
+    // Start from the settled frame the eyes show when the clip begins
+    RoboEyesClipWriter writer(framebuffer, FRAME_MS);
+    if (!settle(eyes, nullptr)) {
+        fprintf(stderr, "eyes don't settle\n");
+        return 1;
+    }
+    writer.addFrame();
+
+    if (strcmp(animation, "blink") == 0) {
+        eyes.blink();
+    } else if (strcmp(animation, "laugh") == 0) {
+        eyes.anim_laugh();
+    } else if (strcmp(animation, "confused") == 0) {
+        eyes.anim_confused();
+    } else {
+        fprintf(stderr, "unknown animation %s\n", animation);
+        return 1;
+    }
+    if (!settle(eyes, &writer)) {
+        fprintf(stderr, "%s doesn't end\n", animation);
+        return 1;
+    }
+
+    if (!writer.writeSource(argv[3], argv[2])) {
+        fprintf(stderr, "can't write %s\n", argv[3]);
+        return 1;
+    }
+    printf("%s: %zu frames, %zu bytes\n", argv[3], writer.size(), writer.encode().size());
+    return 0;
+}
@@ -0,0 +1,168 @@
+// Times drawEyes() on the host frame buffer for a matrix of screen sizes, moods, flicker,
+// curiosity and border radii, and prints one CSV line per case.
+//
+//   roboeyes_bench [frames]
+//
+// Each case walks the eyes through all positions, so nearly every frame moves, and is timed over
+// `frames` calls (default 450) three times on fresh instances, the fastest pass counts. Columns:
+//
+//   width,height,mood,flicker,curious,radius  the case
+//   frames,drawn                              drawEyes() calls and how many of them drew a frame
+//   ns_per_frame                              wall time per call
+//   pixels_per_frame                          pixels that changed on the panel
+//   bytes_per_frame                           frame buffer bytes flushed to the panel
+//   cache_hit_pct                             eye shapes taken from the shape cache
+//
+// Compare the CSV of two builds to spot regressions, ns_per_frame is only comparable on the same machine.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "RoboEyes.hpp"
+
+static constexpr unsigned int FRAME_MS = 10;  // 100 fps
+static constexpr unsigned int FRAMES_PER_POSITION = 25;
+static constexpr unsigned int HALF_LIFE_MS = 40;  // slow enough to still move when the next position comes
+static constexpr int PASSES = 3;
+
+struct Screen {
+    int16_t width;
+    int16_t height;
+};
+
+static const Screen screens[] = {{128, 32}, {128, 64}, {128, 128}, {240, 240}};
+static const unsigned char moods[] = {MOOD_DEFAULT, MOOD_TIRED, MOOD_ANGRY, MOOD_HAPPY};
+static const char* const moodNames[] = {"default", "tired", "angry", "happy"};
+static const byte radii[] = {0, 4, 8, 12, 18};
+static const unsigned char positions[] = {CENTER, N, NE, E, SE, S, SW, W, NW};
+
+struct Result {
+    unsigned long drawn = 0;
+    double nsPerFrame = 0;
+    unsigned long pixels = 0;
+    unsigned long bytes = 0;
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+};
+
+static unsigned int changedPixels(const std::vector<uint8_t>& before, const uint8_t* after) {
+    unsigned int pixels = 0;
+    for (size_t i = 0; i < before.size(); i++) {
+        pixels += __builtin_popcount(before[i] ^ after[i]);
+    }
+    return pixels;
+}
+
+// One case set up from scratch, the host clock makes every instance render the same frames
+class Case {
+   public:
+    Case(const Screen& screen, unsigned char mood, bool flicker, bool curious, byte radius)
+        : framebuffer(screen.width, screen.height),
+          eyes(screen.width, screen.height, 1000 / FRAME_MS, roboEyesDisplay(framebuffer)) {
+        roboEyesHostSetMillis(0);
+        const byte size = eyeSize(screen);
+        eyes.setWidth(size, size);
+        eyes.setHeight(size, size);
+        eyes.setSpacebetween(size * 10 / 36);
+        eyes.setBorderradius(radius, radius);
+        eyes.setHalfLifes(HALF_LIFE_MS, HALF_LIFE_MS, HALF_LIFE_MS, HALF_LIFE_MS);
+        eyes.setMood(mood);
+        eyes.setCuriosity(curious);
+        eyes.setHFlicker(flicker, 2);
+        eyes.setVFlicker(flicker, 2);
+        eyes.open();
+
+        // Open the eyes and fill the shape cache
+        for (unsigned int i = 0; i < FRAMES_PER_POSITION; i++) {
+            step();
+        }
+    }
+
+    // Eyes keep the proportions of the default 36 px eyes on 128x64
+    static byte eyeSize(const Screen& screen) {
+        return min(36 * screen.height / 64, 36 * screen.width / 128);
+    }
+
+    void step() {
+        if (frame % FRAMES_PER_POSITION == 0) {
+            eyes.setPosition(positions[frame / FRAMES_PER_POSITION % sizeof(positions)]);
+        }
+        roboEyesHostAdvanceMillis(FRAME_MS);
+        eyes.drawEyes();
+        frame++;
+    }
+
+    HostFramebuffer framebuffer;
+    RoboEyes eyes;
+    unsigned long frame = 0;
+};
+
+static Result runCase(const Screen& screen, unsigned char mood, bool flicker, bool curious, byte radius, unsigned long frames) {
+    Result result;
+    for (int pass = 0; pass < PASSES; pass++) {
+        Case timed(screen, mood, flicker, curious, radius);
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned long i = 0; i < frames; i++) {
+            timed.step();
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        const double nsPerFrame = std::chrono::duration<double, std::nano>(stop - start).count() / frames;
+        if (pass == 0 || nsPerFrame < result.nsPerFrame) {
+            result.nsPerFrame = nsPerFrame;
+        }
+    }
+
+    // Same frames once more, untimed, for what they change on the panel
+    Case counted(screen, mood, flicker, curious, radius);
+    const size_t frameBytes = screen.width * ((screen.height + 7) / 8);
+    const uint8_t* buffer = counted.framebuffer.getBuffer();
+    std::vector<uint8_t> previous(buffer, buffer + frameBytes);
+    const unsigned long hits = counted.eyes.getShapeCacheHits();
+    const unsigned long misses = counted.eyes.getShapeCacheMisses();
+    const unsigned long bytes = counted.framebuffer.bytesFlushed;
+    const unsigned long flushes = counted.framebuffer.flushes;
+    for (unsigned long i = 0; i < frames; i++) {
+        counted.step();
+        result.pixels += changedPixels(previous, buffer);
+        previous.assign(buffer, buffer + frameBytes);
+    }
+    result.hits = counted.eyes.getShapeCacheHits() - hits;
+    result.misses = counted.eyes.getShapeCacheMisses() - misses;
+    result.bytes = counted.framebuffer.bytesFlushed - bytes;
+    result.drawn = counted.framebuffer.flushes - flushes;  // settled frames send nothing
+    return result;
+}
+
+int main(int argc, char** argv) {
+    const unsigned long frames = argc > 1 ? strtoul(argv[1], nullptr, 10) : 450;
+    if (frames == 0) {
+        fprintf(stderr, "usage: roboeyes_bench [frames]\n");
+        return 1;
+    }
+
+    printf("width,height,mood,flicker,curious,radius,frames,drawn,ns_per_frame,pixels_per_frame,bytes_per_frame,cache_hit_pct\n");
+    for (const Screen& screen : screens) {
+        const byte size = Case::eyeSize(screen);
+        for (size_t mood = 0; mood < sizeof(moods); mood++) {
+            for (int flicker = 0; flicker < 2; flicker++) {
+                for (int curious = 0; curious < 2; curious++) {
+                    for (byte radius : radii) {
+                        if (radius > size / 2) {
+                            continue;  // same shape as the largest radius that fits
+                        }
+                        const Result result = runCase(screen, moods[mood], flicker, curious, radius, frames);
+                        const unsigned long shapes = result.hits + result.misses;
+                        printf("%d,%d,%s,%d,%d,%d,%lu,%lu,%.0f,%.1f,%.1f,%.1f\n",
+                               screen.width, screen.height, moodNames[mood], flicker, curious, radius, frames, result.drawn,
+                               result.nsPerFrame, (double)result.pixels / frames, (double)result.bytes / frames,
+                               shapes ? 100.0 * result.hits / shapes : 0.0);
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
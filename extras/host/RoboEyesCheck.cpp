@@ -0,0 +1,419 @@
+// Regression checks of the host build, prints each failed check and exits with 1 if any failed.
+//
+//   roboeyes_check
+//
+// Built with the smallest shape cache that is allowed, so eviction inside a frame shows, and with
+// ROBOEYES_LARGE_SCREEN for screens wider than 255 pixels.
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "RoboEyes.hpp"
+#include "RoboEyesBatch.hpp"
+#include "RoboEyesClip.hpp"
+#include "RoboEyesGroup.hpp"
+
+static constexpr unsigned int FRAME_MS = 10;  // 100 fps
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+// Eyes of different widths rendered from the cache must match the shapes computed column by column.
+// Both eyes miss in most frames, the right one must not overwrite spans the left one still reads.
+static void checkShapeCacheAsymmetric() {
+    const int16_t width = 128;
+    const int16_t height = 64;
+    std::vector<uint8_t> cached(width * height / 8);
+    std::vector<uint8_t> computed(cached.size());
+    EyeShapeCache cache;
+    bool same = true;
+    for (int frame = 0; frame < 200; frame++) {
+        const int16_t h = 1 + frame / 2 % 36;  // blinking, each shape twice
+        const uint8_t tired = frame / 36 % 2 ? 12 : 0;
+        const uint8_t happy = frame / 72 % 2 ? 10 : 0;
+        EyeShape left(10, 10, 30, h, 8, tired, 0, happy, 36, false);
+        EyeShape right(60, 10, 40, h, 8, tired, 0, happy, 36, true);
+        cache.beginFrame();
+        cache.attach(left);
+        if (!right.useMirrorOf(left)) {
+            cache.attach(right);
+        }
+        PageRaster(cached.data(), width, height).composeEyes(left, right, 0, 0, width, height);
+
+        const EyeShape plainLeft(10, 10, 30, h, 8, tired, 0, happy, 36, false);
+        const EyeShape plainRight(60, 10, 40, h, 8, tired, 0, happy, 36, true);
+        PageRaster(computed.data(), width, height).composeEyes(plainLeft, plainRight, 0, 0, width, height);
+        same &= cached == computed;
+    }
+    check(same, "cached asymmetric eyes match the computed shapes");
+    check(cache.misses > 0 && cache.hits > 0, "asymmetric eyes hit and miss the cache");
+}
+
+static bool sameFrame(HostFramebuffer& a, HostFramebuffer& b) {
+    return memcmp(a.getBuffer(), b.getBuffer(), a.width() * ((a.height() + 7) / 8)) == 0;
+}
+
+// Lit pixels in columns x0..x1 (exclusive)
+static bool litColumns(const HostFramebuffer& framebuffer, int16_t x0, int16_t x1) {
+    for (int16_t x = x0; x < x1; x++) {
+        for (int16_t y = 0; y < framebuffer.height(); y++) {
+            if (framebuffer.getPixel(x, y)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Panel behind a separate frame buffer, only what flush() sends reaches it. Every refuse-th
+// flush finds the panel busy and sends nothing.
+struct CopyPanel {
+    CopyPanel(int16_t width, int16_t height)
+        : panel(width, height),
+          scratch(width * ((height + 7) / 8)) {
+    }
+
+    static uint16_t flush(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+        CopyPanel& self = *static_cast<CopyPanel*>(context);
+        if (self.refuse && ++self.calls % self.refuse == 0) {
+            return 0;
+        }
+        roboEyesCopyWindow(self.panel.getBuffer(), self.panel.width(), data, stride, page0, page1, col0, col1);
+        self.taken++;
+        return (page1 - page0 + 1) * (col1 - col0 + 1);
+    }
+
+    RoboEyesDisplay display() {
+        return {scratch.data(), panel.width(), panel.height(), this, flush, nullptr, false};
+    }
+
+    HostFramebuffer panel;
+    std::vector<uint8_t> scratch;
+    unsigned int refuse = 0;
+    unsigned long calls = 0;
+    unsigned long taken = 0;  // flushes that reached the panel
+};
+
+// Eyes set up the same way for every display path of the large screen check
+static void setUpLargeEyes(RoboEyes& eyes) {
+    eyes.setWidth(100, 100);
+    eyes.setHeight(100, 100);
+    eyes.setBorderradius(18, 18);
+    eyes.setSpacebetween(20);
+    eyes.open();
+}
+
+// A 320 pixel wide screen: the frame buffer, banded and budgeted paths agree, the right eye
+// reaches past column 255 and nothing wraps around to the left edge
+static void checkLargeScreen() {
+    const int16_t width = 320;
+    const int16_t height = 240;
+    HostFramebuffer buffered(width, height);
+    HostFramebuffer banded(width, height);
+    CopyPanel budgeted(width, height);
+    roboEyesHostSetMillis(0);
+    RoboEyes eyesBuffered(width, height, 1000 / FRAME_MS, roboEyesDisplay(buffered));
+    RoboEyes eyesBanded(width, height, 1000 / FRAME_MS, roboEyesBandedDisplay(banded));
+    RoboEyes eyesBudgeted(width, height, 1000 / FRAME_MS, budgeted.display());
+    setUpLargeEyes(eyesBuffered);
+    setUpLargeEyes(eyesBanded);
+    setUpLargeEyes(eyesBudgeted);
+    eyesBudgeted.setFlushBudget(50);  // pieces end past column 255
+
+    bool same = true;
+    bool pastByte = false;
+    bool wrapped = false;
+    static const unsigned char positions[] = {E, SE, NE, CENTER};
+    for (unsigned int frame = 0; frame < 400; frame++) {
+        if (frame % 100 == 0) {
+            eyesBuffered.setPosition(positions[frame / 100]);
+            eyesBanded.setPosition(positions[frame / 100]);
+            eyesBudgeted.setPosition(positions[frame / 100]);
+        }
+        roboEyesHostAdvanceMillis(FRAME_MS);
+        eyesBuffered.update();
+        eyesBanded.update();
+        eyesBudgeted.update();
+        for (int piece = 0; piece < 1000 && eyesBudgeted.flushPending(); piece++) {
+            eyesBudgeted.update();
+        }
+        same &= sameFrame(buffered, banded) && sameFrame(buffered, budgeted.panel);
+        if (frame < 300) {
+            pastByte |= litColumns(buffered, 256, width);
+            wrapped |= litColumns(buffered, 0, 64);  // the left eye stays right of x = 100 there
+        }
+    }
+    check(same, "320 px frame buffer, banded and budgeted frames agree");
+    check(pastByte, "320 px eyes light columns past 255");
+    check(!wrapped, "320 px eyes don't wrap to the left edge");
+}
+
+// Under a flush budget no update() sends more than the budget, buffered or banded, and the frames
+// that arrive piece by piece match the ones sent whole
+static void checkFlushBudget() {
+    HostFramebuffer whole(128, 64);
+    CopyPanel buffered(128, 64);
+    HostFramebuffer banded(128, 64);
+    roboEyesHostSetMillis(0);
+    RoboEyes eyesWhole(128, 64, 1000 / FRAME_MS, roboEyesDisplay(whole));
+    RoboEyes eyesBuffered(128, 64, 1000 / FRAME_MS, buffered.display());
+    RoboEyes eyesBanded(128, 64, 1000 / FRAME_MS, roboEyesBandedDisplay(banded));
+    RoboEyes* const budgeted[] = {&eyesBuffered, &eyesBanded};
+    const unsigned int budget = 20;  // less than one page of an eye
+    for (RoboEyes* e : budgeted) {
+        e->setFlushBudget(budget);
+    }
+
+    bool same = true;
+    bool withinBudget = true;
+    bool split = false;
+    static const unsigned char positions[] = {E, SW, N, CENTER};
+    for (unsigned int frame = 0; frame < 400; frame++) {
+        RoboEyes* const all[] = {&eyesWhole, &eyesBuffered, &eyesBanded};
+        for (RoboEyes* e : all) {
+            if (frame % 100 == 0) {
+                e->open();
+                e->setPosition(positions[frame / 100]);
+                e->setMood(frame / 100);
+            }
+            if (frame % 100 == 50) {
+                e->blink();
+            }
+        }
+        roboEyesHostAdvanceMillis(FRAME_MS);
+        eyesWhole.update();
+        for (RoboEyes* e : budgeted) {
+            e->update();
+            withinBudget &= e->bytesFlushed <= budget;
+            for (int piece = 0; piece < 1000 && e->flushPending(); piece++) {
+                split = true;
+                e->update();
+                withinBudget &= e->bytesFlushed <= budget;
+            }
+        }
+        same &= sameFrame(whole, buffered.panel) && sameFrame(whole, banded);
+    }
+    check(withinBudget, "no update() sends more than the flush budget");
+    check(split, "budgeted frames go out over several updates");
+    check(same, "budgeted buffered and banded frames match whole ones");
+}
+
+// A clip baked on a 320 pixel wide screen plays back the frames it recorded
+static void checkLargeScreenClip() {
+    const int16_t width = 320;
+    const int16_t height = 240;
+    HostFramebuffer recorded(width, height);
+    HostFramebuffer played(width, height);
+    roboEyesHostSetMillis(0);
+    RoboEyes recorder(width, height, 1000 / FRAME_MS, roboEyesDisplay(recorded));
+    RoboEyes eyes(width, height, 1000 / FRAME_MS, roboEyesDisplay(played));
+    setUpLargeEyes(recorder);
+    setUpLargeEyes(eyes);
+    recorder.setPosition(E);
+    eyes.setPosition(E);
+    for (unsigned int frame = 0; frame < 100; frame++) {
+        roboEyesHostAdvanceMillis(FRAME_MS);
+        recorder.update();
+        eyes.update();
+    }
+
+    RoboEyesClipWriter writer(recorded, FRAME_MS);
+    std::vector<std::vector<uint8_t>> frames;
+    recorder.blink();
+    for (unsigned int frame = 0; frame < 40; frame++) {
+        writer.addFrame();
+        frames.emplace_back(recorded.getBuffer(), recorded.getBuffer() + width * ((height + 7) / 8));
+        roboEyesHostAdvanceMillis(FRAME_MS);
+        recorder.update();
+    }
+    const std::vector<uint8_t> clip = writer.encode();
+
+    RoboEyesClipPlayer player(eyes);
+    check(player.play(clip.data()), "320 px clip fits a 320 px display");
+    bool same = true;
+    for (const std::vector<uint8_t>& frame : frames) {
+        player.update();
+        same &= memcmp(played.getBuffer(), frame.data(), frame.size()) == 0;
+        roboEyesHostAdvanceMillis(FRAME_MS);
+    }
+    check(same, "320 px clip plays back the recorded frames");
+}
+
+// A second drawEyes() in the same millisecond moves nothing, the eyes must still finish opening
+static void checkSameMillisecondFrame() {
+    HostFramebuffer reference(128, 64);
+    HostFramebuffer doubled(128, 64);
+    roboEyesHostSetMillis(0);
+    RoboEyes eyesReference(128, 64, 1000 / FRAME_MS, roboEyesDisplay(reference));
+    RoboEyes eyesDoubled(128, 64, 1000 / FRAME_MS, roboEyesDisplay(doubled));
+    eyesReference.open();
+    eyesDoubled.open();
+
+    bool settledEarly = false;
+    for (unsigned int frame = 0; frame < 200; frame++) {
+        roboEyesHostAdvanceMillis(FRAME_MS);
+        eyesReference.update();
+        eyesDoubled.update();
+        if (frame == 3) {
+            eyesDoubled.drawEyes();
+            settledEarly = eyesDoubled.isSettled();
+        }
+    }
+    check(!settledEarly, "a frame in the same millisecond doesn't settle the eyes mid-transition");
+    check(sameFrame(reference, doubled), "eyes drawn twice in one millisecond reach the same frame");
+}
+
+static unsigned long plainTime = 0;
+static unsigned long wrappingTime = 0;
+
+static unsigned long plainClock() {
+    return plainTime;
+}
+
+static unsigned long wrappingClock() {
+    return wrappingTime;
+}
+
+// Blinking, idle moves and laughing across the wrap of the clock look the same as anywhere else
+static void checkClockWrap() {
+    HostFramebuffer plain(128, 64);
+    HostFramebuffer wrapping(128, 64);
+    RoboEyes eyesPlain(128, 64, 1000 / FRAME_MS, roboEyesDisplay(plain));
+    RoboEyes eyesWrapping(128, 64, 1000 / FRAME_MS, roboEyesDisplay(wrapping));
+    RoboEyes* const eyes[] = {&eyesPlain, &eyesWrapping};
+    plainTime = 1000000;
+    wrappingTime = ULONG_MAX - 3000;
+    eyesPlain.setClock(plainClock);
+    eyesWrapping.setClock(wrappingClock);
+    for (RoboEyes* e : eyes) {
+        e->setRandomSeed(1);
+        e->setAutoblinker(true, 1, 1);
+        e->setIdleMode(true, 1, 1);
+        e->open();
+    }
+
+    bool same = true;
+    for (unsigned int frame = 0; frame < 800; frame++) {
+        if (frame == 250) {
+            for (RoboEyes* e : eyes) {
+                e->anim_laugh();
+            }
+        }
+        plainTime += FRAME_MS;
+        wrappingTime += FRAME_MS;
+        eyesPlain.update();
+        eyesWrapping.update();
+        same &= sameFrame(plain, wrapping) && eyesPlain.isSettled() == eyesWrapping.isSettled() &&
+                eyesPlain.timeToDeadline() == eyesWrapping.timeToDeadline();
+    }
+    check(same, "eyes behave the same across the wrap of the clock");
+}
+
+// A happy batch face mid-blink keeps the happy eyelids of its default height, as RoboEyes does
+static void checkBatchHappyBlink() {
+    const int16_t width = 128;
+    const int16_t height = 64;
+    RoboEyesBatch batch(2, width, height);
+    batch.setHeight(1, 30, 30);
+    for (size_t face = 0; face < batch.size(); face++) {
+        batch.setTarget(face, BATCH_HAPPY, 5);
+        batch.setTarget(face, BATCH_HEIGHT_L, 14);
+        batch.setTarget(face, BATCH_HEIGHT_R, 14);
+    }
+    batch.step(10000);
+
+    bool same = true;
+    std::vector<uint8_t> rendered(batch.frameBytes());
+    std::vector<uint8_t> expected(batch.frameBytes());
+    for (size_t face = 0; face < batch.size(); face++) {
+        const int16_t heightDefault = face ? 30 : EYE_HEIGHT;
+        const EyeShape left(batch.get(face, BATCH_X_L), batch.get(face, BATCH_Y_L), EYE_WIDTH, 14, EYE_BORDER_RADIUS,
+                            0, 0, 5, heightDefault, false);
+        const EyeShape right(batch.get(face, BATCH_X_R), batch.get(face, BATCH_Y_R), EYE_WIDTH, 14, EYE_BORDER_RADIUS,
+                             0, 0, 5, heightDefault, true);
+        PageRaster(expected.data(), width, height).composeEyes(left, right, 0, 0, width, height);
+        batch.render(face, rendered.data());
+        same &= rendered == expected;
+    }
+    check(same, "blinking happy batch faces use the default height");
+}
+
+static unsigned long groupTime = 0;
+
+static unsigned long groupClock() {
+    return groupTime;
+}
+
+// A group on its own clock shares the bus by that clock alone, millis() stays at 0 throughout
+static void checkGroupClock() {
+    HostFramebuffer left(128, 64);
+    HostFramebuffer right(128, 64);
+    roboEyesHostSetMillis(0);
+    RoboEyes eyesLeft(128, 64, 1000 / FRAME_MS, roboEyesDisplay(left));
+    RoboEyes eyesRight(128, 64, 1000 / FRAME_MS, roboEyesDisplay(right));
+    RoboEyesGroup group;
+    group.setClock(groupClock);
+    group.add(eyesLeft);
+    group.add(eyesRight);
+    group.setBandwidth(20000);
+    eyesLeft.setIdleMode(true, 1, 1);
+    eyesRight.setIdleMode(true, 1, 1);
+    eyesLeft.open();
+    eyesRight.open();
+
+    unsigned long bytes = 0;
+    for (groupTime = 1; groupTime <= 3000; groupTime++) {
+        group.update();
+        bytes += group.bytesFlushed;
+    }
+    check(bytes > 0 && bytes <= 20000 * 3 + 2000, "group on its own clock sends within its bandwidth");
+    check(group.getFps(0) > 0 && group.getFps(1) > 0, "group on its own clock measures frame rates");
+    check(eyesLeft.getTime() == groupClock(), "members take the clock of the group");
+}
+
+// Whole frames to a panel that is busy every other flush: only frames it took count
+static void checkGroupBusyDisplay() {
+    CopyPanel panel(128, 64);
+    panel.refuse = 2;
+    groupTime = 0;
+    RoboEyes eyes(128, 64, 1000 / FRAME_MS, panel.display());
+    RoboEyesGroup group;
+    group.setClock(groupClock);
+    group.add(eyes);
+    group.setBandwidth(0, 0);
+    eyes.setIdleMode(true, 1, 1);
+    eyes.open();
+
+    panel.taken = 0;
+    for (groupTime = 1; groupTime <= 1000; groupTime++) {
+        group.update();
+    }
+    check(panel.taken > 0 && group.getFps(0) == panel.taken, "group counts only frames a busy display took");
+}
+
+int main() {
+    checkShapeCacheAsymmetric();
+    checkLargeScreen();
+    checkFlushBudget();
+    checkLargeScreenClip();
+    checkSameMillisecondFrame();
+    checkClockWrap();
+    checkBatchHappyBlink();
+    checkGroupClock();
+    checkGroupBusyDisplay();
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Renders a scripted RoboEyes sequence without a display and optionally dumps the frames.
+//
+//   roboeyes_dump [frames] [pattern]
+//
+// pattern is a printf pattern for the frame number, e.g. out/frame%04d.png. The extension
+// picks the format, .png or .pbm. Without a pattern nothing is written, which is the
+// setup to profile with perf.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "RoboEyes.hpp"
+#include "RoboEyesTimeline.hpp"
+
+static constexpr unsigned int FRAME_MS = 10;  // 100 fps
+
+// Walk through the moods, positions and animations, so every drawing path is hit
+static const RoboEyesKeyframe script[] = {
+    {0, KEYFRAME_MOOD, MOOD_DEFAULT},
+    {0, KEYFRAME_CURIOSITY, 0},
+    {0, KEYFRAME_POSITION, CENTER},
+    {0, KEYFRAME_AUTOBLINKER, 1, 1, 1},
+    {0, KEYFRAME_IDLE, 1, 1, 1},
+    {0, KEYFRAME_OPEN},
+    {1000, KEYFRAME_MOOD, MOOD_TIRED},
+    {2000, KEYFRAME_MOOD, MOOD_ANGRY},
+    {3000, KEYFRAME_MOOD, MOOD_HAPPY},
+    {3000, KEYFRAME_LAUGH},
+    {4000, KEYFRAME_MOOD, MOOD_DEFAULT},
+    {4000, KEYFRAME_CONFUSED},
+    {5000, KEYFRAME_CURIOSITY, 1},
+    {5000, KEYFRAME_IDLE, 0},
+    {5000, KEYFRAME_POSITION, W},
+    {5600, KEYFRAME_POSITION, E},
+    {6200, KEYFRAME_WIDTH, 30, 40},
+    {6200, KEYFRAME_RADIUS, 3, 15},
+    {6200, KEYFRAME_MOOD, MOOD_TIRED},
+    {7000, KEYFRAME_SPACE, -5},
+    {7000, KEYFRAME_MOOD, MOOD_ANGRY},
+    {7000, KEYFRAME_HFLICKER, 1, 2},
+    {8000, KEYFRAME_HFLICKER, 0},
+    {8000, KEYFRAME_VFLICKER, 1, 3},
+    {8000, KEYFRAME_MOOD, MOOD_HAPPY},
+    {8990, KEYFRAME_VFLICKER, 0},
+    {8990, KEYFRAME_WIDTH, 36, 36},
+    {8990, KEYFRAME_RADIUS, 8, 8},
+    {8990, KEYFRAME_SPACE, 10},
+};
+
+int main(int argc, char** argv) {
+    const unsigned long frames = argc > 1 ? strtoul(argv[1], nullptr, 10) : 900;
+    const char* pattern = argc > 2 ? argv[2] : nullptr;
+    const bool png = pattern && strlen(pattern) > 4 && strcmp(pattern + strlen(pattern) - 4, ".png") == 0;
+
+    HostFramebuffer framebuffer(128, 64);
+    RoboEyes eyes(128, 64, 1000 / FRAME_MS, roboEyesDisplay(framebuffer));
+    RoboEyesTimeline timeline(eyes, script, 900 * FRAME_MS);
+    timeline.start();
+
+    unsigned long drawn = 0;
+    for (unsigned long frame = 0; frame < frames; frame++) {
+        roboEyesHostSetMillis(frame * FRAME_MS);
+        timeline.update();
+        eyes.update();
+        drawn += eyes.lastUpdateDrew();
+
+        if (pattern) {
+            char path[256];
+            snprintf(path, sizeof(path), pattern, (int)frame);
+            if (!(png ? framebuffer.writePNG(path) : framebuffer.writePBM(path))) {
+                fprintf(stderr, "can't write %s\n", path);
+                return 1;
+            }
+        }
+    }
+
+    printf("%lu frames, %lu drawn, %lu bytes flushed, shape cache %lu hits %lu misses\n",
+           frames, drawn, framebuffer.bytesFlushed, eyes.getShapeCacheHits(), eyes.getShapeCacheMisses());
+    return 0;
+}
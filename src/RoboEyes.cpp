@@ -4,13 +4,56 @@
 //  GENERAL METHODS
 //*********************************************************************************************
 
-RoboEyes::RoboEyes(int width, int height, byte frameRate, Adafruit_SSD1306* oled)
-    : display(oled),
+RoboEyes::RoboEyes(int width, int height, byte frameRate, const RoboEyesDisplay& display)
+    : display(display),
+      transferring(0),
+      settled(0),
+      drewLastUpdate(0),
+      tweensResting(1),
+      redraw(0),
+      pacing(PACING_FREE),
       screenWidth(width),
-      screenHeight(height) {
-    display->clearDisplay();
-    display->display();
+      screenHeight(height),
+      tired(0),
+      angry(0),
+      happy(0),
+      curious(0),
+      eyeL_open(0),
+      eyeR_open(0),
+      hFlicker(0),
+      hFlickerAlternate(0),
+      vFlicker(0),
+      vFlickerAlternate(0),
+      autoblinker(0),
+      idle(0),
+      confused(0),
+      confusedToggle(1),
+      laugh(0),
+      laughToggle(1) {
+    static uint32_t instances = 0;
+    setRandomSeed(++instances);
+
+    // Start from a blank screen, later frames only touch what changed
+    if (display.banded) {
+        PageRaster(display.buffer, display.width, display.height, 0, 1).clear(BGCOLOR);
+        for (uint8_t page = 0; page < (display.height + 7) / 8; page++) {
+            display.flush(display.context, display.buffer, display.width, page, page, 0, display.width - 1);
+        }
+    } else if (display.buffer) {
+        PageRaster(display.buffer, display.width, display.height).clear(BGCOLOR);
+    } else {
+        for (int16_t x = 0; x < display.width; x++) {
+            display.fillColumn(display.context, x, 0, display.height, BGCOLOR);
+        }
+    }
+    if (!display.banded) {
+        flushRect({0, 0, display.width, display.height});
+    }
     setFramerate(frameRate);
+    setHalfLifes(frameInterval, frameInterval, frameInterval, frameInterval);
+
+    const int16_t x = ((int)screenWidth - (EYE_WIDTH + EYE_SPACE_BETWEEN + EYE_WIDTH)) / 2;
+    const int16_t y = ((int)screenHeight - EYE_HEIGHT) / 2;
 
     // Initialize LEFT eye (eyeL)
     eyeL = {
@@ -27,12 +70,13 @@ RoboEyes::RoboEyes(int width, int height, byte frameRate, Adafruit_SSD1306* oled
         .borderRadiusCurrent = EYE_BORDER_RADIUS,
         .borderRadiusNext = EYE_BORDER_RADIUS,
         // Coordinates
-        .xDefault = ((screenWidth) - (EYE_WIDTH + EYE_SPACE_BETWEEN + EYE_WIDTH)) / 2,
-        .x = ((screenWidth) - (EYE_WIDTH + EYE_SPACE_BETWEEN + EYE_WIDTH)) / 2,
-        .xNext = ((screenWidth) - (EYE_WIDTH + EYE_SPACE_BETWEEN + EYE_WIDTH)) / 2,
-        .yDefault = ((screenHeight - EYE_HEIGHT) / 2),
-        .y = ((screenHeight - EYE_HEIGHT) / 2),
-        .yNext = ((screenHeight - EYE_HEIGHT) / 2)};
+        .xDefault = x,
+        .x = x,
+        .xNext = x,
+        .yDefault = y,
+        .y = y,
+        .yNext = y,
+        .tweens = {}};
 
     // Initialize RIGHT eye (eyeR)
     eyeR = {
@@ -49,22 +93,144 @@ RoboEyes::RoboEyes(int width, int height, byte frameRate, Adafruit_SSD1306* oled
         .borderRadiusCurrent = EYE_BORDER_RADIUS,
         .borderRadiusNext = EYE_BORDER_RADIUS,
         // oordinates
-        .xDefault = eyeL.xDefault + EYE_WIDTH + EYE_SPACE_BETWEEN,
-        .x = eyeL.x + EYE_WIDTH + EYE_SPACE_BETWEEN,
-        .xNext = eyeL.xNext + EYE_WIDTH + EYE_SPACE_BETWEEN,
+        .xDefault = (int16_t)(x + EYE_WIDTH + EYE_SPACE_BETWEEN),
+        .x = (int16_t)(x + EYE_WIDTH + EYE_SPACE_BETWEEN),
+        .xNext = (int16_t)(x + EYE_WIDTH + EYE_SPACE_BETWEEN),
         .yDefault = eyeL.yDefault,
         .y = eyeL.y,
-        .yNext = eyeL.yNext};
+        .yNext = eyeL.yNext,
+        .tweens = {}};
 }
 
 void RoboEyes::update() {
+    drewLastUpdate = 0;
+    bytesFlushed = 0;
+    const unsigned long now = clock();
+    if (now - statsTimer >= 1000) {
+        fps = statsFrames * 1000.0f / (now - statsTimer);
+        jitter = statsIntervals ? (float)statsJitter / statsIntervals : 0;
+        statsFrames = 0;
+        statsIntervals = 0;
+        statsJitter = 0;
+        statsTimer = now;
+    }
+    // Finish the frame on its way first, every call sends its share regardless of the framerate
+    if (transferring) {
+        ROBOEYES_PROFILE_BEGIN(profile);
+        continueFlush();
+        ROBOEYES_PROFILE_EXTEND(profile, PROFILE_FLUSH);
+        return;
+    }
     // Limit drawing updates to defined max framerate
-    if (millis() - fpsTimer >= frameInterval) {
-        drawEyes();
-        fpsTimer = millis();
+    if (now - fpsTimer >= frameInterval) {
+        // Nothing moves while settled, only a due timer or running macro can change the frame
+        if (settled && !macroPending(now)) {
+            if (!unflushed.empty()) {
+                flushRect(unflushed);  // last frame is still waiting for the display
+            }
+            return;
+        }
+        // A settled pause is neither a missed slot nor a frame interval
+        const bool resumed = settled;
+        const bool measurable = !tweensResting;
+        const unsigned long sinceLastFrame = now - tweenTimer;
+        const unsigned long skipped = advanceFrameClock(now, resumed);
+        ROBOEYES_PROFILE_DROP(profile, skipped);
+        settled = 0;
+        drawFrame(now);
+        if (drewLastUpdate) {
+            statsFrames++;
+            if (measurable) {
+                statsIntervals++;
+                statsJitter += sinceLastFrame > frameInterval ? sinceLastFrame - frameInterval : frameInterval - sinceLastFrame;
+            }
+        }
+    }
+}
+
+unsigned long RoboEyes::advanceFrameClock(unsigned long now, bool resumed) {
+    const unsigned long behind = (now - fpsTimer) / frameInterval - 1;  // slots missed before this one
+    if (resumed || pacing == PACING_FREE) {
+        fpsTimer = now;
+        return resumed ? 0 : behind;
+    }
+    // On the grid, this frame takes the oldest slot still due
+    fpsTimer += frameInterval;
+    const unsigned long allowed = pacing == PACING_CATCH_UP ? maxCatchUp : 0;
+    if (behind <= allowed) {
+        return 0;
     }
+    fpsTimer += (behind - allowed) * frameInterval;
+    return behind - allowed;
+}
+
+void RoboEyes::wake() {
+    settled = 0;
 }
 
+void RoboEyes::setClock(RoboEyesClock clock) {
+    this->clock = clock;
+}
+
+unsigned long RoboEyes::getTime() {
+    return clock();
+}
+
+void RoboEyes::setRandomSeed(uint32_t seed) {
+    randomState = seed ? seed : 1;  // xorshift never leaves 0
+}
+
+bool RoboEyes::isSettled() {
+    return settled;
+}
+
+bool RoboEyes::lastUpdateDrew() {
+    return drewLastUpdate;
+}
+
+void RoboEyes::setFlushBudget(unsigned int bytes) {
+    flushBudget = bytes;
+}
+
+bool RoboEyes::flushPending() {
+    return transferring;
+}
+
+unsigned long RoboEyes::nextDeadline() {
+    const unsigned long now = clock();
+    if (transferring) {
+        return now;  // every update() sends the next part
+    }
+    const unsigned long nextFrame = fpsTimer + frameInterval;
+    if (!settled || !unflushed.empty()) {
+        return nextFrame;
+    }
+
+    // Settled, only the macro timers can start a new frame. Compared by difference to survive millis() wrapping.
+    unsigned long deadline = now + 0x7FFFFFFFUL;
+    if (autoblinker && (long)(blinktimer - deadline) < 0) {
+        deadline = blinktimer;
+    }
+    if (idle && (long)(idleAnimationTimer - deadline) < 0) {
+        deadline = idleAnimationTimer;
+    }
+    if ((long)(deadline - nextFrame) < 0) {
+        deadline = nextFrame;  // a due timer still waits for the frame rate limit
+    }
+    return deadline;
+}
+
+unsigned long RoboEyes::timeToDeadline() {
+    const long remaining = nextDeadline() - clock();
+    return remaining > 0 ? remaining : 0;
+}
+
+#ifdef ROBOEYES_PROFILE
+RoboEyesProfile& RoboEyes::getProfile() {
+    return profile;
+}
+#endif
+
 //*********************************************************************************************
 //  SETTERS METHODS
 //*********************************************************************************************
@@ -73,14 +239,44 @@ void RoboEyes::setFramerate(byte fps) {
     frameInterval = 1000 / fps;
 }
 
-void RoboEyes::setWidth(byte leftEye, byte rightEye) {
+void RoboEyes::setFramePacing(FramePacing pacing, uint8_t maxCatchUp) {
+    this->pacing = pacing;
+    this->maxCatchUp = maxCatchUp;
+}
+
+float RoboEyes::getFps() {
+    return fps;
+}
+
+float RoboEyes::getFrameJitter() {
+    return jitter;
+}
+
+void RoboEyes::setHalfLifes(unsigned int size, unsigned int position, unsigned int radius, unsigned int eyelids) {
+    sizeHalfLife = size;
+    positionHalfLife = position;
+    radiusHalfLife = radius;
+    eyelidsHalfLife = eyelids;
+}
+
+void RoboEyes::setEasings(Easing size, Easing position, Easing radius, Easing eyelids) {
+    wake();
+    sizeEasing = size;
+    positionEasing = position;
+    radiusEasing = radius;
+    eyelidsEasing = eyelids;
+}
+
+void RoboEyes::setWidth(EyeSize leftEye, EyeSize rightEye) {
+    wake();
     eyeL.widthNext = leftEye;
     eyeR.widthNext = rightEye;
     eyeL.widthDefault = leftEye;
     eyeR.widthDefault = rightEye;
 }
 
-void RoboEyes::setHeight(byte leftEye, byte rightEye) {
+void RoboEyes::setHeight(EyeSize leftEye, EyeSize rightEye) {
+    wake();
     eyeL.heightNext = leftEye;
     eyeR.heightNext = rightEye;
     eyeL.heightDefault = leftEye;
@@ -89,6 +285,7 @@ void RoboEyes::setHeight(byte leftEye, byte rightEye) {
 
 // Set border radius for left and right eye
 void RoboEyes::setBorderradius(byte leftEye, byte rightEye) {
+    wake();
     eyeL.borderRadiusNext = leftEye;
     eyeR.borderRadiusNext = rightEye;
     eyeL.borderRadiusDefault = leftEye;
@@ -97,12 +294,14 @@ void RoboEyes::setBorderradius(byte leftEye, byte rightEye) {
 
 // Set space between the eyes, can also be negative
 void RoboEyes::setSpacebetween(int space) {
+    wake();
     spaceBetweenNext = space;
     spaceBetweenDefault = space;
 }
 
 // Set mood expression
 void RoboEyes::setMood(unsigned char mood) {
+    wake();
     switch (mood) {
         case MOOD_TIRED:
             tired = 1;
@@ -129,6 +328,7 @@ void RoboEyes::setMood(unsigned char mood) {
 
 // Set predefined position
 void RoboEyes::setPosition(unsigned char position) {
+    wake();
     switch (position) {
         case N:
             // North, top center
@@ -180,26 +380,33 @@ void RoboEyes::setPosition(unsigned char position) {
 
 // Set automated eye blinking, minimal blink interval in full seconds and blink interval variation range in full seconds
 void RoboEyes::setAutoblinker(bool active, int interval, int variation) {
-    autoblinker = active;
+    setAutoblinker(active);
     blinkInterval = interval;
     blinkIntervalVariation = variation;
 }
 void RoboEyes::setAutoblinker(bool active) {
+    if (active && !autoblinker) {
+        blinktimer = clock();  // first blink right away, a timer left from long ago could lie past the wrap
+    }
     autoblinker = active;
 }
 
 // Set idle mode - automated eye repositioning, minimal time interval in full seconds and time interval variation range in full seconds
 void RoboEyes::setIdleMode(bool active, int interval, int variation) {
-    idle = active;
+    setIdleMode(active);
     idleInterval = interval;
     idleIntervalVariation = variation;
 }
 void RoboEyes::setIdleMode(bool active) {
+    if (active && !idle) {
+        idleAnimationTimer = clock();
+    }
     idle = active;
 }
 
 // Set curious mode - the respectively outer eye gets larger when looking left or right
 void RoboEyes::setCuriosity(bool curiousBit) {
+    wake();
     curious = curiousBit;
 }
 
@@ -210,19 +417,23 @@ void RoboEyes::setCuriosity(bool curiousBit) {
 
 // Set horizontal flickering (displacing eyes left/right)
 void RoboEyes::setHFlicker(bool flickerBit, byte Amplitude) {
+    wake();
     hFlicker = flickerBit;          // turn flicker on or off
     hFlickerAmplitude = Amplitude;  // define amplitude of flickering in pixels
 }
 void RoboEyes::setHFlicker(bool flickerBit) {
+    wake();
     hFlicker = flickerBit;  // turn flicker on or off
 }
 
 // Set vertical flickering (displacing eyes up/down)
 void RoboEyes::setVFlicker(bool flickerBit, byte Amplitude) {
+    wake();
     vFlicker = flickerBit;          // turn flicker on or off
     vFlickerAmplitude = Amplitude;  // define amplitude of flickering in pixels
 }
 void RoboEyes::setVFlicker(bool flickerBit) {
+    wake();
     vFlicker = flickerBit;  // turn flicker on or off
 }
 
@@ -240,6 +451,16 @@ int RoboEyes::getScreenConstraint_Y() {
     return screenHeight - eyeL.heightDefault;  // using default height here, because height will vary when blinking and in curious mode
 }
 
+// Returns how many eye shapes were found in the shape cache
+unsigned long RoboEyes::getShapeCacheHits() {
+    return shapeCache.hits;
+}
+
+// Returns how many eye shapes had to be rasterized
+unsigned long RoboEyes::getShapeCacheMisses() {
+    return shapeCache.misses;
+}
+
 //*********************************************************************************************
 //  BASIC ANIMATION METHODS
 //*********************************************************************************************
@@ -247,6 +468,7 @@ int RoboEyes::getScreenConstraint_Y() {
 // BLINKING FOR BOTH EYES AT ONCE
 // Close both eyes
 void RoboEyes::close() {
+    wake();
     eyeL.heightNext = 1;  // closing left eye
     eyeR.heightNext = 1;  // closing right eye
     eyeL_open = 0;        // left eye not opened (=closed)
@@ -255,6 +477,7 @@ void RoboEyes::close() {
 
 // Open both eyes
 void RoboEyes::open() {
+    wake();
     eyeL_open = 1;  // left eye opened - if true, drawEyes() will take care of opening eyes again
     eyeR_open = 1;  // right eye opened
 }
@@ -268,6 +491,7 @@ void RoboEyes::blink() {
 // BLINKING FOR SINGLE EYES, CONTROL EACH EYE SEPARATELY
 // Close eye(s)
 void RoboEyes::close(bool left, bool right) {
+    wake();
     if (left) {
         eyeL.heightNext = 1;  // blinking left eye
         eyeL_open = 0;        // left eye not opened (=closed)
@@ -280,6 +504,7 @@ void RoboEyes::close(bool left, bool right) {
 
 // Open eye(s)
 void RoboEyes::open(bool left, bool right) {
+    wake();
     if (left) {
         eyeL_open = 1;  // left eye opened - if true, drawEyes() will take care of opening eyes again
     }
@@ -300,11 +525,13 @@ void RoboEyes::blink(bool left, bool right) {
 
 // Play confused animation - one shot animation of eyes shaking left and right
 void RoboEyes::anim_confused() {
+    wake();
     confused = 1;
 }
 
 // Play laugh animation - one shot animation of eyes shaking up and down
 void RoboEyes::anim_laugh() {
+    wake();
     laugh = 1;
 }
 
@@ -312,13 +539,31 @@ void RoboEyes::anim_laugh() {
 //  PRE-CALCULATIONS AND ACTUAL DRAWINGS
 //*********************************************************************************************
 
-void RoboEyes::apply_macro() {
+bool RoboEyes::macroPending(unsigned long now) {
+    return hFlicker || vFlicker || laugh || confused ||
+           (autoblinker && (long)(now - blinktimer) >= 0) ||
+           (idle && (long)(now - idleAnimationTimer) >= 0);
+}
+
+// xorshift32, a few shifts instead of the division of the Arduino random()
+long RoboEyes::randomBelow(long howbig) {
+    if (howbig <= 0) {
+        return 0;
+    }
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState % howbig;
+}
+
+void RoboEyes::apply_macro(unsigned long now) {
     //// APPLYING MACRO ANIMATIONS ////
+    // Timers are compared by difference, like in nextDeadline(), to survive millis() wrapping
 
     if (autoblinker) {
-        if (millis() >= blinktimer) {
+        if ((long)(now - blinktimer) >= 0) {
             blink();
-            blinktimer = millis() + (blinkInterval * 1000) + (random(blinkIntervalVariation) * 1000);  // calculate next time for blinking
+            blinktimer = now + (blinkInterval * 1000) + (randomBelow(blinkIntervalVariation) * 1000);  // calculate next time for blinking
         }
     }
 
@@ -326,9 +571,9 @@ void RoboEyes::apply_macro() {
     if (laugh) {
         if (laughToggle) {
             setVFlicker(1, 5);
-            laughAnimationTimer = millis();
+            laughAnimationTimer = now;
             laughToggle = 0;
-        } else if (millis() >= laughAnimationTimer + laughAnimationDuration) {
+        } else if (now - laughAnimationTimer >= (unsigned long)laughAnimationDuration) {
             setVFlicker(0, 0);
             laughToggle = 1;
             laugh = 0;
@@ -339,9 +584,9 @@ void RoboEyes::apply_macro() {
     if (confused) {
         if (confusedToggle) {
             setHFlicker(1, 20);
-            confusedAnimationTimer = millis();
+            confusedAnimationTimer = now;
             confusedToggle = 0;
-        } else if (millis() >= confusedAnimationTimer + confusedAnimationDuration) {
+        } else if (now - confusedAnimationTimer >= (unsigned long)confusedAnimationDuration) {
             setHFlicker(0, 0);
             confusedToggle = 1;
             confused = 0;
@@ -350,10 +595,10 @@ void RoboEyes::apply_macro() {
 
     // Idle - eyes moving to random positions on screen
     if (idle) {
-        if (millis() >= idleAnimationTimer) {
-            eyeL.xNext = random(getScreenConstraint_X());
-            eyeL.yNext = random(getScreenConstraint_Y());
-            idleAnimationTimer = millis() + (idleInterval * 1000) + (random(idleIntervalVariation) * 1000);  // calculate next time for eyes repositioning
+        if ((long)(now - idleAnimationTimer) >= 0) {
+            eyeL.xNext = randomBelow(getScreenConstraint_X());
+            eyeL.yNext = randomBelow(getScreenConstraint_Y());
+            idleAnimationTimer = now + (idleInterval * 1000) + (randomBelow(idleIntervalVariation) * 1000);  // calculate next time for eyes repositioning
         }
     }
 
@@ -383,8 +628,32 @@ void RoboEyes::apply_macro() {
 }
 
 void RoboEyes::drawEyes() {
+    drawFrame(clock());
+}
+
+void RoboEyes::drawFrame(const unsigned long now) {
+    // Drawing now would mix two frames on the panel
+    if (transferring) {
+        ROBOEYES_PROFILE_BEGIN(profile);
+        continueFlush();
+        ROBOEYES_PROFILE_EXTEND(profile, PROFILE_FLUSH);
+        return;
+    }
+    ROBOEYES_PROFILE_BEGIN(profile);
+
+    // Animated state before this frame, if nothing changes the eyes have settled
+    const Eye_s lastEyeL = eyeL;
+    const Eye_s lastEyeR = eyeR;
+    const int lastSpaceBetween = spaceBetweenCurrent;
+    const byte lastEyelids[] = {eyelidsTiredHeight, eyelidsTiredHeightNext, eyelidsAngryHeight, eyelidsAngryHeightNext, eyelidsHappyBottomOffset, eyelidsHappyBottomOffsetNext};
+
     //// PRE-CALCULATIONS - EYE SIZES AND VALUES FOR ANIMATION TWEENINGS ////
 
+    // Transitions advance by the time since the last step, a late frame catches up instead of slowing down
+    const unsigned long elapsed = tweensResting ? frameInterval : now - tweenTimer;
+    tweenTimer = now;
+    bool moving = false;  // any transition still on its way, even by less than a pixel
+
     // Vertical size offset for larger eyes when looking left or right (curious gaze)
     unsigned int heighOffsetL = 0;
     unsigned int heighOffsetR = 0;
@@ -396,7 +665,7 @@ void RoboEyes::drawEyes() {
             heighOffsetL = 0;
         }  // left eye
 
-        if (eyeR.xNext >= screenWidth - eyeR.widthCurrent - 10) {
+        if (eyeR.xNext >= (int)screenWidth - eyeR.widthCurrent - 10) {
             heighOffsetR = EYE_OFFSET_CURIOUS;
         } else {
             heighOffsetR = 0;
@@ -404,11 +673,11 @@ void RoboEyes::drawEyes() {
     }
 
     // Left eye height
-    eyeL.heightCurrent = (eyeL.heightCurrent + eyeL.heightNext + heighOffsetL) / 2;
+    moving |= eyeL.tweens.height.step(eyeL.heightCurrent, (EyeSize)(eyeL.heightNext + heighOffsetL), elapsed, sizeHalfLife, sizeEasing);
     eyeL.y = ((screenHeight - eyeL.heightDefault) / 2) - heighOffsetL;
 
     // Right eye height
-    eyeR.heightCurrent = (eyeR.heightCurrent + eyeR.heightNext + heighOffsetR) / 2;
+    moving |= eyeR.tweens.height.step(eyeR.heightCurrent, (EyeSize)(eyeR.heightNext + heighOffsetR), elapsed, sizeHalfLife, sizeEasing);
     eyeR.y = ((screenHeight - eyeR.heightDefault) / 2) - heighOffsetR;
 
     // Open eyes again after closing them
@@ -424,38 +693,31 @@ void RoboEyes::drawEyes() {
     }
 
     // Left eye width
-    eyeL.widthCurrent = (eyeL.widthCurrent + eyeL.widthNext) / 2;
+    moving |= eyeL.tweens.width.step(eyeL.widthCurrent, eyeL.widthNext, elapsed, sizeHalfLife, sizeEasing);
     // Right eye width
-    eyeR.widthCurrent = (eyeR.widthCurrent + eyeR.widthNext) / 2;
+    moving |= eyeR.tweens.width.step(eyeR.widthCurrent, eyeR.widthNext, elapsed, sizeHalfLife, sizeEasing);
 
     // Space between eyes
-    spaceBetweenCurrent = (spaceBetweenCurrent + spaceBetweenNext) / 2;
+    moving |= spaceBetweenTween.step(spaceBetweenCurrent, spaceBetweenNext, elapsed, positionHalfLife, positionEasing, Tween::UNBOUNDED);
 
     // Left eye coordinates
-    eyeL.x = (eyeL.x + eyeL.xNext) / 2;
+    moving |= eyeL.tweens.x.step(eyeL.x, eyeL.xNext, elapsed, positionHalfLife, positionEasing, Tween::UNBOUNDED);
+    // y restarts from the vertical center every frame, so it is a fixed blend rather than a transition
     eyeL.y = (eyeL.y + eyeL.yNext) / 2;
     // Right eye coordinates
     eyeR.xNext = eyeL.xNext + eyeL.widthCurrent + spaceBetweenCurrent;  // right eye's x position depends on left eyes position + the space between
     eyeR.yNext = eyeL.yNext;                                            // right eye's y position should be the same as for the left eye
-    eyeR.x = (eyeR.x + eyeR.xNext) / 2;
+    moving |= eyeR.tweens.x.step(eyeR.x, eyeR.xNext, elapsed, positionHalfLife, positionEasing, Tween::UNBOUNDED);
     eyeR.y = (eyeR.y + eyeR.yNext) / 2;
 
     // Left eye border radius
-    eyeL.borderRadiusCurrent = (eyeL.borderRadiusCurrent + eyeL.borderRadiusNext) / 2;
+    moving |= eyeL.tweens.borderRadius.step(eyeL.borderRadiusCurrent, eyeL.borderRadiusNext, elapsed, radiusHalfLife, radiusEasing);
     // Right eye border radius
-    eyeR.borderRadiusCurrent = (eyeR.borderRadiusCurrent + eyeR.borderRadiusNext) / 2;
+    moving |= eyeR.tweens.borderRadius.step(eyeR.borderRadiusCurrent, eyeR.borderRadiusNext, elapsed, radiusHalfLife, radiusEasing);
 
-    //// ACTUAL DRAWINGS ////
-
-    display->clearDisplay();  // start with a blank screen
-
-    // Draw basic eye rectangles
-    display->fillRoundRect(eyeL.x, eyeL.y, eyeL.widthCurrent, eyeL.heightCurrent, eyeL.borderRadiusCurrent, MAINCOLOR);  // left eye
-                                                                                                                         // if (!cyclops) {
-    display->fillRoundRect(eyeR.x, eyeR.y, eyeR.widthCurrent, eyeR.heightCurrent, eyeR.borderRadiusCurrent, MAINCOLOR);  // right eye
-    // }
-
-    apply_macro();
+    ROBOEYES_PROFILE_LAP(profile, PROFILE_TWEEN);
+    apply_macro(now);
+    ROBOEYES_PROFILE_LAP(profile, PROFILE_MACRO);
 
     // Prepare mood type transitions
 
@@ -477,20 +739,234 @@ void RoboEyes::drawEyes() {
         eyelidsHappyBottomOffsetNext = 0;
     }
 
-    // Draw tired top eyelids
-    eyelidsTiredHeight = (eyelidsTiredHeight + eyelidsTiredHeightNext) / 2;
-    display->fillTriangle(eyeL.x, eyeL.y - 1, eyeL.x + eyeL.widthCurrent, eyeL.y - 1, eyeL.x, eyeL.y + eyelidsTiredHeight - 1, BGCOLOR);                      // left eye
-    display->fillTriangle(eyeR.x, eyeR.y - 1, eyeR.x + eyeR.widthCurrent, eyeR.y - 1, eyeR.x + eyeR.widthCurrent, eyeR.y + eyelidsTiredHeight - 1, BGCOLOR);  // right eye
+    // Tired and angry top eyelids
+    moving |= eyelidsTiredTween.step(eyelidsTiredHeight, eyelidsTiredHeightNext, elapsed, eyelidsHalfLife, eyelidsEasing);
+    moving |= eyelidsAngryTween.step(eyelidsAngryHeight, eyelidsAngryHeightNext, elapsed, eyelidsHalfLife, eyelidsEasing);
+    // Happy bottom eyelids
+    moving |= eyelidsHappyTween.step(eyelidsHappyBottomOffset, eyelidsHappyBottomOffsetNext, elapsed, eyelidsHalfLife, eyelidsEasing);
+    ROBOEYES_PROFILE_LAP(profile, PROFILE_TWEEN);
+
+    // An unchanged state would redraw the identical frame, no need to draw or send it again
+    const byte eyelids[] = {eyelidsTiredHeight, eyelidsTiredHeightNext, eyelidsAngryHeight, eyelidsAngryHeightNext, eyelidsHappyBottomOffset, eyelidsHappyBottomOffsetNext};
+    const bool unchanged = !(hFlicker || vFlicker || laugh || confused) && !moving && !redraw &&
+                           eyeL == lastEyeL && eyeR == lastEyeR && spaceBetweenCurrent == lastSpaceBetween &&
+                           memcmp(eyelids, lastEyelids, sizeof(eyelids)) == 0;
+    // A second frame in the same millisecond moves nothing, the transitions haven't arrived for that
+    settled = unchanged && elapsed > 0;
+    tweensResting = settled;
+    redraw = 0;
+    if (unchanged) {
+        bytesFlushed = 0;
+        return;
+    }
+
+    //// ACTUAL DRAWINGS ////
+
+    // Eyelids only ever erase, so the lit pixels of this frame lie inside the eye bodies
+    Rect_s drawn = eyesBounds();
+
+    // Only the union of the previous and the current eye areas can differ on screen
+    const Rect_s dirty = drawn.unite(lastDrawn);
+    lastDrawn = drawn;
+
+    // Visible eye shapes with the eyelids already cut out, so every pixel is written once
+    EyeShape shapeL = eyeShape(eyeL, false);
+    EyeShape shapeR = eyeShape(eyeR, true);
+    shapeCache.beginFrame();
+    attachShapes(shapeL, shapeR);
+    if (display.banded) {
+        streamShapes(shapeL, shapeR, dirty);
+    } else {
+        drawShapes(shapeL, shapeR, dirty);
+        ROBOEYES_PROFILE_LAP(profile, PROFILE_RASTER);
+        flushRect(dirty);  // show drawings on display
+        ROBOEYES_PROFILE_LAP(profile, PROFILE_FLUSH);
+    }
+    drewLastUpdate = 1;
+    ROBOEYES_PROFILE_END(profile, frameInterval);
+
+}  // end of drawFrame method
+
+void RoboEyes::drawShapes(const EyeShape& left, const EyeShape& right, Rect_s area) {
+    if (area.empty()) {
+        return;
+    }
+    if (display.buffer) {
+        PageRaster(display.buffer, display.width, display.height).composeEyes(left, right, area.x0, area.y0, area.x1, area.y1);
+        return;
+    }
+
+    // Same page aligned window as composeEyes() writes and flushRect() sends
+    const int16_t y0 = area.y0 & ~7;
+    const int16_t y1 = min((area.y1 + 7) & ~7, (int)display.height);
+    const EyeShape* eyes[] = {&left, &right};
+    for (int16_t x = area.x0; x < area.x1; x++) {
+        display.fillColumn(display.context, x, y0, y1, BGCOLOR);
+        for (const EyeShape* eye : eyes) {
+            const int16_t c = x - eye->x;
+            int16_t top, bottom;
+            if (c >= 0 && c < eye->width && eye->column(c, top, bottom)) {
+                // Clipped here, the display never sees rows outside of the window
+                top = max(top, y0);
+                bottom = min(bottom, y1);
+                if (top < bottom) {
+                    display.fillColumn(display.context, x, top, bottom, MAINCOLOR);
+                }
+            }
+        }
+    }
+}
+
+EyeShape RoboEyes::eyeShape(const Eye_s& eye, bool rightEye) {
+    return EyeShape(eye.x, eye.y, eye.widthCurrent, eye.heightCurrent, eye.borderRadiusCurrent,
+                    eyelidsTiredHeight, eyelidsAngryHeight, eyelidsHappyBottomOffset, eye.heightDefault, rightEye);
+}
+
+void RoboEyes::attachShapes(EyeShape& left, EyeShape& right) {
+    // Eyes off screen are culled before they are rasterized
+    const int16_t width = min((int16_t)screenWidth, display.width);
+    const int16_t height = min((int16_t)screenHeight, display.height);
+    if (left.overlaps(0, 0, width, height)) {
+        shapeCache.attach(left);
+    }
+    if (right.overlaps(0, 0, width, height) && !right.useMirrorOf(left)) {  // symmetric eyes only rasterize the left one
+        shapeCache.attach(right);
+    }
+}
+
+void RoboEyes::streamShapes(const EyeShape& left, const EyeShape& right, Rect_s area) {
+    bytesFlushed = 0;
+    if (area.empty()) {
+        return;
+    }
+    if (flushBudget) {
+        transferring = 1;
+        transferPage0 = area.y0 / 8;
+        transferPage1 = (area.y1 - 1) / 8;
+        transferCol0 = area.x0;
+        transferCol1 = area.x1 - 1;
+        sendPage = transferPage0;
+        sendCol = area.x0;
+        continueBand(left, right);
+        return;
+    }
+    // The band is rendered from the shapes again for every page, nothing else holds the frame
+    for (uint8_t page = area.y0 / 8; page <= (area.y1 - 1) / 8; page++) {
+        PageRaster(display.buffer, display.width, display.height, page, 1).composeEyes(left, right, area.x0, area.y0, area.x1, area.y1);
+        ROBOEYES_PROFILE_LAP(profile, PROFILE_RASTER);
+        bytesFlushed += display.flush(display.context, display.buffer, display.width, page, page, area.x0, area.x1 - 1);
+        ROBOEYES_PROFILE_LAP(profile, PROFILE_FLUSH);
+    }
+}
+
+RoboEyes::Rect_s RoboEyes::eyesBounds() {
+    Rect_s area = {
+        min(eyeL.x, eyeR.x),
+        min(eyeL.y, eyeR.y),
+        max((int16_t)(eyeL.x + eyeL.widthCurrent), (int16_t)(eyeR.x + eyeR.widthCurrent)),
+        max((int16_t)(eyeL.y + eyeL.heightCurrent), (int16_t)(eyeR.y + eyeR.heightCurrent))};
+
+    int16_t width = min((int16_t)screenWidth, display.width);
+    int16_t height = min((int16_t)screenHeight, display.height);
+    area.x0 = max(area.x0, (int16_t)0);
+    area.y0 = max(area.y0, (int16_t)0);
+    area.x1 = min(area.x1, width);
+    area.y1 = min(area.y1, height);
+    if (area.empty()) {
+        area = {0, 0, 0, 0};  // off screen
+    }
+    return area;
+}
+
+void RoboEyes::flushRect(Rect_s area) {
+    bytesFlushed = 0;
+    area = area.unite(unflushed);
+    if (area.empty()) {
+        return;  // nothing changed on screen
+    }
 
-    // Draw angry top eyelids
-    eyelidsAngryHeight = (eyelidsAngryHeight + eyelidsAngryHeightNext) / 2;
-    display->fillTriangle(eyeL.x, eyeL.y - 1, eyeL.x + eyeL.widthCurrent, eyeL.y - 1, eyeL.x + eyeL.widthCurrent, eyeL.y + eyelidsAngryHeight - 1, BGCOLOR);  // left eye
-    display->fillTriangle(eyeR.x, eyeR.y - 1, eyeR.x + eyeR.widthCurrent, eyeR.y - 1, eyeR.x, eyeR.y + eyelidsAngryHeight - 1, BGCOLOR);                      // right eye
+    if (display.flush == nullptr) {
+        return;  // drawn straight to the panel
+    }
 
-    eyelidsHappyBottomOffset = (eyelidsHappyBottomOffset + eyelidsHappyBottomOffsetNext) / 2;
-    display->fillRoundRect(eyeL.x - 1, (eyeL.y + eyeL.heightCurrent) - eyelidsHappyBottomOffset + 1, eyeL.widthCurrent + 2, eyeL.heightDefault, eyeL.borderRadiusCurrent, BGCOLOR);  // left eye
-    display->fillRoundRect(eyeR.x - 1, (eyeR.y + eyeR.heightCurrent) - eyelidsHappyBottomOffset + 1, eyeR.widthCurrent + 2, eyeR.heightDefault, eyeR.borderRadiusCurrent, BGCOLOR);  // right eye
+    const uint8_t page0 = area.y0 / 8;
+    const uint8_t page1 = (area.y1 - 1) / 8;
+    if (flushBudget && display.buffer) {
+        unflushed = {0, 0, 0, 0};
+        transferring = 1;
+        transferPage0 = page0;
+        transferPage1 = page1;
+        transferCol0 = area.x0;
+        transferCol1 = area.x1 - 1;
+        sendPage = page0;
+        sendCol = area.x0;
+        continueFlush();
+        return;
+    }
 
-    display->display();  // show drawings on display
+    const uint8_t* data = display.buffer ? display.buffer + page0 * display.width : nullptr;
+    bytesFlushed = display.flush(display.context, data, display.width, page0, page1, area.x0, area.x1 - 1);
+    unflushed = bytesFlushed ? Rect_s{0, 0, 0, 0} : area;
+}
 
-}  // end of drawEyes method
\ No newline at end of file
+void RoboEyes::continueFlush() {
+    if (display.banded) {
+        // Nothing holds the frame but the eye state, which only moves once the transfer is complete
+        EyeShape left = eyeShape(eyeL, false);
+        EyeShape right = eyeShape(eyeR, true);
+        attachShapes(left, right);
+        continueBand(left, right);
+        return;
+    }
+    bytesFlushed = 0;
+    unsigned int budget = flushBudget ? flushBudget : UINT16_MAX;
+    const uint16_t rowBytes = transferCol1 - transferCol0 + 1;
+    while (transferring && budget > 0) {
+        // Whole pages in one go while the budget allows, else part of the current page
+        uint8_t page1 = sendPage;
+        uint16_t col1 = transferCol1;
+        if (sendCol == transferCol0 && budget >= rowBytes) {
+            page1 = min((unsigned int)transferPage1, sendPage + budget / rowBytes - 1);
+        } else if (budget < (unsigned int)(transferCol1 - sendCol + 1)) {
+            col1 = sendCol + budget - 1;
+        }
+        const uint16_t sent = display.flush(display.context, display.buffer + sendPage * display.width, display.width, sendPage, page1, sendCol, col1);
+        if (sent == 0) {
+            return;  // display busy, carry on with the next update
+        }
+        budget -= (page1 - sendPage + 1) * (col1 - sendCol + 1);
+        bytesFlushed += sent;
+
+        if (col1 == transferCol1) {
+            transferring = page1 < transferPage1;
+            sendPage = page1 + 1;
+            sendCol = transferCol0;
+        } else {
+            sendCol = col1 + 1;
+        }
+    }
+}
+
+void RoboEyes::continueBand(const EyeShape& left, const EyeShape& right) {
+    bytesFlushed = 0;
+    unsigned int budget = flushBudget ? flushBudget : UINT16_MAX;
+    // The band holds one page, so every piece ends at a page boundary at the latest
+    while (transferring && budget > 0) {
+        const uint16_t col1 = min((unsigned int)transferCol1, sendCol + budget - 1);
+        PageRaster(display.buffer, display.width, display.height, sendPage, 1).composeEyes(left, right, sendCol, sendPage * 8, col1 + 1, sendPage * 8 + 8);
+        const uint16_t sent = display.flush(display.context, display.buffer, display.width, sendPage, sendPage, sendCol, col1);
+        if (sent == 0) {
+            return;  // display busy, the piece is rendered again with the next update
+        }
+        budget -= col1 - sendCol + 1;
+        bytesFlushed += sent;
+
+        if (col1 == transferCol1) {
+            transferring = sendPage < transferPage1;
+            sendPage++;
+            sendCol = transferCol0;
+        } else {
+            sendCol = col1 + 1;
+        }
+    }
+}
@@ -1,7 +1,7 @@
 /*
  * FORK of RoboEyes for OLED Displays V 0.0.1
- * Draws smoothly animated robot eyes on OLED displays, based on the Adafruit GFX
- * library's graphics primitives, such as rounded rectangles and triangles.
+ * Draws smoothly animated robot eyes on OLED displays, straight into a page ordered
+ * frame buffer. Adapters for the supported display libraries are in RoboEyesDisplay.hpp.
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,8 +17,19 @@
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <Adafruit_SSD1306.h>
+#ifndef _ROBOEYES_HPP
+#define _ROBOEYES_HPP
+
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include "RoboEyesHost.hpp"
+#endif
+
+#include "RoboEyesDisplay.hpp"
+#include "RoboEyesProfile.hpp"
+#include "RoboEyesRaster.hpp"
+#include "RoboEyesTween.hpp"
 
 // Usage of monochrome display colors
 #define BGCOLOR 0    // background and overlays
@@ -26,10 +37,28 @@
 
 static constexpr uint8_t EYE_HEIGHT = 36;
 static constexpr uint8_t EYE_WIDTH = 36;
-static constexpr uint8_t EYE_BORDER_RADIUS = 8;
+static constexpr uint8_t EYE_BORDER_RADIUS = ROBOEYES_MAX_RADIUS < 8 ? ROBOEYES_MAX_RADIUS : 8;  // 8 unless the corner tables stop below
 static constexpr uint8_t EYE_SPACE_BETWEEN = 10;
 static constexpr uint8_t EYE_OFFSET_CURIOUS = 8;
 
+// Eye widths, heights and screen columns take a byte, enough for screens up to 255 pixels.
+// Build with ROBOEYES_LARGE_SCREEN for bigger ones.
+#ifdef ROBOEYES_LARGE_SCREEN
+typedef uint16_t EyeSize;
+#else
+typedef uint8_t EyeSize;
+#endif
+
+// Time source in milliseconds, millis() unless RoboEyes::setClock() picks another one
+typedef unsigned long (*RoboEyesClock)();
+
+// When update() draws the next frame, see RoboEyes::setFramePacing()
+enum FramePacing : uint8_t {
+    PACING_FREE,      // one frame interval after the last frame was drawn, so a late update() delays all later frames (default)
+    PACING_SKIP,      // on a fixed grid of frame intervals, slots missed by a late update() are left out
+    PACING_CATCH_UP,  // on the same grid, missed slots are drawn by the next update() calls, at most maxCatchUp behind
+};
+
 // For mood type switch
 enum Mood : uint8_t {
     MOOD_DEFAULT,
@@ -62,31 +91,103 @@ class RoboEyes {
    protected:
     struct Eye_s {
         // eye width
-        unsigned int widthDefault;
-        unsigned int widthCurrent;
-        unsigned int widthNext;
+        EyeSize widthDefault;
+        EyeSize widthCurrent;
+        EyeSize widthNext;
 
         // eye height
-        unsigned int heightDefault;
-        unsigned int heightCurrent;  // starts closed
-        unsigned int heightNext;
+        EyeSize heightDefault;
+        EyeSize heightCurrent;  // starts closed
+        EyeSize heightNext;
 
         // eyey radius
         byte borderRadiusDefault;
         byte borderRadiusCurrent;
         byte borderRadiusNext;
 
-        // eye coordinates
-        unsigned int xDefault;
-        unsigned int x;
-        unsigned int xNext;
-        unsigned int yDefault;
-        unsigned int y;
-        unsigned int yNext;
+        // eye coordinates, signed as flicker and negative spacing push eyes past the screen edge
+        int16_t xDefault;
+        int16_t x;
+        int16_t xNext;
+        int16_t yDefault;
+        int16_t y;
+        int16_t yNext;
+
+        // Sub-pixel state of the transitions above, their movement is reported by Tween::step()
+        struct Tweens_s {
+            Tween width;
+            Tween height;
+            Tween borderRadius;
+            Tween x;
+        } tweens;
+
+        bool operator==(const Eye_s& other) const {
+            return widthDefault == other.widthDefault && widthCurrent == other.widthCurrent && widthNext == other.widthNext &&
+                   heightDefault == other.heightDefault && heightCurrent == other.heightCurrent && heightNext == other.heightNext &&
+                   borderRadiusDefault == other.borderRadiusDefault && borderRadiusCurrent == other.borderRadiusCurrent && borderRadiusNext == other.borderRadiusNext &&
+                   xDefault == other.xDefault && x == other.x && xNext == other.xNext &&
+                   yDefault == other.yDefault && y == other.y && yNext == other.yNext;
+        }
+        bool operator!=(const Eye_s& other) const { return !(*this == other); }
+    };
+
+    // Screen area in pixels, x1/y1 exclusive
+    struct Rect_s {
+        int16_t x0;
+        int16_t y0;
+        int16_t x1;
+        int16_t y1;
+
+        bool empty() const { return x1 <= x0 || y1 <= y0; }
+
+        // Smallest area covering both
+        Rect_s unite(const Rect_s& other) const {
+            if (other.empty()) {
+                return *this;
+            }
+            if (empty()) {
+                return other;
+            }
+            return {min(x0, other.x0), min(y0, other.y0), max(x1, other.x1), max(y1, other.y1)};
+        }
     };
 
    private:
-    Adafruit_SSD1306* display;
+    friend class RoboEyesClipPlayer;  // sends baked frames through display
+
+    // Fields below are ordered by alignment, widest first, so the compiler only pads where
+    // ROBOEYES_STATE_PADDING says
+    RoboEyesDisplay display;
+
+    // Rasterized eye shapes of recent frames
+    EyeShapeCache shapeCache;
+
+#ifdef ROBOEYES_PROFILE
+    RoboEyesProfile profile;
+#endif
+
+    // Time of the last tween step
+    unsigned long tweenTimer = 0;
+
+    // Read once per frame, every timer of that frame compares against the same time
+    RoboEyesClock clock = millis;
+
+    // Frames and their intervals counted since statsTimer, turned into fps and jitter every second
+    unsigned long statsJitter = 0;  // sum of the differences to frameInterval in milliseconds
+    unsigned long statsTimer = 0;
+    float fps = 0;
+    float jitter = 0;
+    uint16_t statsFrames = 0;
+    uint16_t statsIntervals = 0;
+
+    // xorshift32 state of the blink and idle intervals, independent of random() and other instances
+    uint32_t randomState;
+
+    // Sub-pixel state of the transitions outside of Eye_s
+    Tween spaceBetweenTween;
+    Tween eyelidsTiredTween;
+    Tween eyelidsAngryTween;
+    Tween eyelidsHappyTween;
 
     // Constants (prefer constexpr over #define in C++)
 
@@ -94,7 +195,69 @@ class RoboEyes {
     Eye_s eyeL;
     Eye_s eyeR;
 
-    void apply_macro();
+    // Area lit by the previous frame, everything outside of it is known to be blank
+    Rect_s lastDrawn = {0, 0, 0, 0};
+
+    // Changed area the display was too busy to take, offered again with the next flush
+    Rect_s unflushed = {0, 0, 0, 0};
+
+    // Frame being sent piece by piece under a flush budget, inclusive pages and columns. The columns
+    // take 16 bits with any EyeSize, so the layout around them is the same for every screen size.
+    uint16_t transferCol0;
+    uint16_t transferCol1;
+    uint16_t sendCol;
+    uint8_t transferPage0;
+    uint8_t transferPage1;
+    uint8_t sendPage;  // next byte to send
+
+    // State flags packed into one byte, initialized by the constructor
+    bool transferring : 1;    // a frame is partly sent
+    bool settled : 1;         // all tweens reached their targets and no macro animation is running
+    bool drewLastUpdate : 1;  // did the last update() send a new frame to the display?
+    bool tweensResting : 1;   // last tween step changed nothing, the time since then doesn't count
+    bool redraw : 1;          // the screen shows something else, draw the next frame even if nothing moves
+    uint8_t pacing : 2;       // FramePacing
+    uint8_t maxCatchUp = 4;   // slots PACING_CATCH_UP may lag behind before skipping
+
+    void apply_macro(unsigned long now);
+
+    // True if a timer or macro animation needs a new frame while settled
+    bool macroPending(unsigned long now);
+
+    // Uniform in [0, howbig), 0 if howbig isn't positive
+    long randomBelow(long howbig);
+
+    // drawEyes() with the time of this frame
+    void drawFrame(unsigned long now);
+
+    // Move fpsTimer to the slot of the frame drawn now, returns the slots skipped
+    unsigned long advanceFrameClock(unsigned long now, bool resumed);
+
+    // Bounding box of both eye bodies, clipped to the screen
+    Rect_s eyesBounds();
+
+    // Send only the pages and columns covered by area and the still unflushed area to the display
+    void flushRect(Rect_s area);
+
+    // Send the next flushBudget bytes of the frame in transfer
+    void continueFlush();
+
+    // Same for a banded display, rendering each piece into the band before it is sent
+    void continueBand(const EyeShape& left, const EyeShape& right);
+
+    // Visible shape of eye in its current state, with the eyelids already cut out
+    EyeShape eyeShape(const Eye_s& eye, bool rightEye);
+
+    // Look up both shapes in the shape cache, eyes off screen are left to be culled
+    void attachShapes(EyeShape& left, EyeShape& right);
+
+    // Render both eye shapes into the page aligned area, straight into the display buffer,
+    // or column by column for displays without one
+    void drawShapes(const EyeShape& left, const EyeShape& right, Rect_s area);
+
+    // Render the area page by page into the single page buffer of a banded display,
+    // sending each page right away, or piece by piece under a flush budget
+    void streamShapes(const EyeShape& left, const EyeShape& right, Rect_s area);
 
    public:
     // For general setup - screen size and max. frame rate
@@ -102,18 +265,21 @@ class RoboEyes {
     unsigned int screenHeight = 64;   // OLED display height, in pixels
     unsigned int frameInterval = 20;  // default value for 50 frames per second (1000/50 = 20 milliseconds)
     unsigned long fpsTimer = 0;       // for timing the frames per second
+    unsigned int bytesFlushed = 0;    // frame buffer bytes pushed to the display by the last update()
+    unsigned int flushBudget = 0;     // max. frame buffer bytes a single update() sends, 0 = whole frames
 
     unsigned int screenOffsetX = 0;     // Screen begin offset, in pixels
     unsigned int screenOffoffsetY = 0;  // Screen begin offset, in pixels
 
-    // For controlling mood types and expressions
-    bool tired = 0;
-    bool angry = 0;
-    bool happy = 0;
-    bool curious = 0;    // if true, draw the outer eye larger when looking left or right
-    // bool cyclops = 0;    // if true, draw only one eye
-    bool eyeL_open = 0;  // left eye opened or closed?
-    bool eyeR_open = 0;  // right eye opened or closed?
+    // For controlling mood types and expressions. This and the other flags below are bitfields,
+    // all cleared by the constructor.
+    bool tired : 1;
+    bool angry : 1;
+    bool happy : 1;
+    bool curious : 1;    // if true, draw the outer eye larger when looking left or right
+    // bool cyclops : 1;    // if true, draw only one eye
+    bool eyeL_open : 1;  // left eye opened or closed?
+    bool eyeR_open : 1;  // right eye opened or closed?
 
     //*********************************************************************************************
     //  Eyes Geometry
@@ -131,73 +297,149 @@ class RoboEyes {
     byte eyelidsHappyBottomOffset = 0;
     byte eyelidsHappyBottomOffsetNext = 0;
     // Space between eyes
-    int spaceBetweenDefault = 10;
-    int spaceBetweenCurrent = spaceBetweenDefault;
-    int spaceBetweenNext = 10;
+    int16_t spaceBetweenDefault = 10;
+    int16_t spaceBetweenCurrent = spaceBetweenDefault;
+    int16_t spaceBetweenNext = 10;
+
+    //*********************************************************************************************
+    //  Transitions
+    //*********************************************************************************************
+
+    // Half-life of each transition in milliseconds, the time it takes to cover half of the remaining
+    // distance. Independent of the frame rate, they default to the frame interval given to the constructor.
+    unsigned int sizeHalfLife = 20;      // eye width and height, blinking
+    unsigned int positionHalfLife = 20;  // eye position and space between
+    unsigned int radiusHalfLife = 20;    // border radius
+    unsigned int eyelidsHalfLife = 20;   // tired, angry and happy eyelids
+
+    // Curve of each transition, see Easing
+    Easing sizeEasing = EASE_EXPONENTIAL;
+    Easing positionEasing = EASE_EXPONENTIAL;
+    Easing radiusEasing = EASE_EXPONENTIAL;
+    Easing eyelidsEasing = EASE_EXPONENTIAL;
 
     //*********************************************************************************************
     //  Macro Animations
     //*********************************************************************************************
 
     // Animation - horizontal flicker/shiver
-    bool hFlicker = 0;
-    bool hFlickerAlternate = 0;
-    byte hFlickerAmplitude = 2;
+    bool hFlicker : 1;
+    bool hFlickerAlternate : 1;
 
     // Animation - vertical flicker/shiver
-    bool vFlicker = 0;
-    bool vFlickerAlternate = 0;
-    byte vFlickerAmplitude = 10;
+    bool vFlicker : 1;
+    bool vFlickerAlternate : 1;
 
     // Animation - auto blinking
-    bool autoblinker = 0;            // activate auto blink animation
-    int blinkInterval = 1;           // basic interval between each blink in full seconds
-    int blinkIntervalVariation = 4;  // interval variaton range in full seconds, random number inside of given range will be add to the basic blinkInterval, set to 0 for no variation
-    unsigned long blinktimer = 0;    // for organising eyeblink timing
+    bool autoblinker : 1;  // activate auto blink animation
 
     // Animation - idle mode: eyes looking in random directions
-    bool idle = 0;
-    int idleInterval = 1;                  // basic interval between each eye repositioning in full seconds
-    int idleIntervalVariation = 3;         // interval variaton range in full seconds, random number inside of given range will be add to the basic idleInterval, set to 0 for no variation
-    unsigned long idleAnimationTimer = 0;  // for organising eyeblink timing
+    bool idle : 1;
 
     // Animation - eyes confused: eyes shaking left and right
-    bool confused = 0;
-    unsigned long confusedAnimationTimer = 0;
-    int confusedAnimationDuration = 500;
-    bool confusedToggle = 1;
+    bool confused : 1;
+    bool confusedToggle : 1;
 
     // Animation - eyes laughing: eyes shaking up and down
-    bool laugh = 0;
-    unsigned long laughAnimationTimer = 0;
+    bool laugh : 1;
+    bool laughToggle : 1;
+
+    // Settings and timing of the animations above, ordered by size so nothing is padded
+    byte hFlickerAmplitude = 2;
+    byte vFlickerAmplitude = 10;
+    int blinkInterval = 1;                 // basic interval between each blink in full seconds
+    int blinkIntervalVariation = 4;        // interval variaton range in full seconds, random number inside of given range will be add to the basic blinkInterval, set to 0 for no variation
+    int idleInterval = 1;                  // basic interval between each eye repositioning in full seconds
+    int idleIntervalVariation = 3;         // interval variaton range in full seconds, random number inside of given range will be add to the basic idleInterval, set to 0 for no variation
+    int confusedAnimationDuration = 500;
     int laughAnimationDuration = 500;
-    bool laughToggle = 1;
+    unsigned long blinktimer = 0;          // for organising eyeblink timing
+    unsigned long idleAnimationTimer = 0;  // for organising eyeblink timing
+    unsigned long confusedAnimationTimer = 0;
+    unsigned long laughAnimationTimer = 0;
 
     //*********************************************************************************************
     //  GENERAL METHODS
     //*********************************************************************************************
 
-    RoboEyes(int width, int height, byte frameRate, Adafruit_SSD1306* oled);
-    RoboEyes(int width, int height, byte frameRate, Adafruit_SSD1306* oled, EyeSettings eyeL, EyeSettings eyeR);
+    // display comes from one of the adapters, e.g. roboEyesDisplay(oled) from RoboEyesSSD1306.hpp
+    RoboEyes(int width, int height, byte frameRate, const RoboEyesDisplay& display);
+    RoboEyes(int width, int height, byte frameRate, const RoboEyesDisplay& display, EyeSettings eyeL, EyeSettings eyeR);
 
     /*!
         @brief Startup RoboEyes with defined screen-width, screen-height and max. frames per second
 
     */
-    // void begin(int width, int height, byte frameRate, Adafruit_SSD1306* oled);
+    // void begin(int width, int height, byte frameRate, const RoboEyesDisplay& display);
 
     void update();
 
+    // Leave the settled state, needed after changing public fields directly
+    void wake();
+
+    // Take the time from clock instead of millis(), e.g. a simulated clock for tests
+    void setClock(RoboEyesClock clock);
+
+    // Time of the current clock in milliseconds
+    unsigned long getTime();
+
+    // Restart the random sequence of the autoblinker and idle mode. Instances are seeded
+    // 1, 2, 3, ... in construction order, so every run repeats the same blinks unless this is
+    // called with something random, e.g. esp_random()
+    void setRandomSeed(uint32_t seed);
+
+    // True if the eyes stopped moving and update() skips drawing until something changes
+    bool isSettled();
+
+    // True if the last update() call actually sent a frame to the display
+    bool lastUpdateDrew();
+
+    // Spread sending a frame over several update() calls, at most bytes per call (0 = off).
+    // A new frame is only drawn once the previous one is complete, so frames never mix on the panel.
+    void setFlushBudget(unsigned int bytes);
+
+    // True while a frame is partly sent, update() then continues it instead of drawing
+    bool flushPending();
+
+    // millis() at which update() next has work to do: the next frame while anything moves or a
+    // frame is still being sent, else the next blink or idle move. Nothing is missed by sleeping
+    // until then, unless a setter is called in between. Far ahead (2^31 ms) if nothing is scheduled.
+    unsigned long nextDeadline();
+
+    // Milliseconds until nextDeadline(), 0 if update() should run right away
+    unsigned long timeToDeadline();
+
+#ifdef ROBOEYES_PROFILE
+    // Where the time of the recent frames went, e.g. getProfile().print(Serial)
+    RoboEyesProfile& getProfile();
+#endif
+
     //*********************************************************************************************
     //  SETTERS METHODS
     //*********************************************************************************************
 
-    // Calculate frame interval based on defined frameRate
+    // Calculate frame interval based on defined frameRate, transitions keep their speed
     void setFramerate(byte fps);
 
-    void setWidth(byte leftEye, byte rightEye);
+    // PACING_FREE, PACING_SKIP or PACING_CATCH_UP. The fixed grid keeps the frame rate even if
+    // drawing or the rest of loop() takes part of the interval, and the frames evenly spaced.
+    void setFramePacing(FramePacing pacing, uint8_t maxCatchUp = 4);
 
-    void setHeight(byte leftEye, byte rightEye);
+    // Frames per second drawn over the last second
+    float getFps();
+
+    // Average difference of the frame intervals to the set interval over the last second, in milliseconds
+    float getFrameJitter();
+
+    // Set the half-lifes of the transitions in milliseconds
+    void setHalfLifes(unsigned int size, unsigned int position, unsigned int radius, unsigned int eyelids);
+
+    // Set the curves of the transitions: EASE_EXPONENTIAL, EASE_IN_OUT or EASE_SPRING
+    void setEasings(Easing size, Easing position, Easing radius, Easing eyelids);
+
+    void setWidth(EyeSize leftEye, EyeSize rightEye);
+
+    void setHeight(EyeSize leftEye, EyeSize rightEye);
 
     // Set border radius for left and right eye
     void setBorderradius(byte leftEye, byte rightEye);
@@ -250,6 +492,12 @@ class RoboEyes {
     // Returns the max y position for left eye
     int getScreenConstraint_Y();
 
+    // Returns how many eye shapes were found in the shape cache
+    unsigned long getShapeCacheHits();
+
+    // Returns how many eye shapes had to be rasterized
+    unsigned long getShapeCacheMisses();
+
     //*********************************************************************************************
     //  BASIC ANIMATION METHODS
     //*********************************************************************************************
@@ -291,3 +539,47 @@ class RoboEyes {
     void drawEyes();
 
 };  // end of class roboEyes
+
+// RAM of one instance besides its shape cache, display handle and profile, by part. Each part adds up
+// the fields it names, so a field that isn't listed here fails the static_assert below.
+// Eye geometry: Default/Current/Next of width, height, border radius, x and y per eye, the eyelid
+// heights, the space between the eyes and the flicker amplitudes
+#define ROBOEYES_GEOMETRY_BYTES (2 * (6 * sizeof(EyeSize) + 3 + 6 * sizeof(int16_t)) + 8 + 3 * sizeof(int16_t) + 2)
+// Sub-pixel state of the 4 transitions of each eye and the 4 shared ones
+#define ROBOEYES_TWEEN_BYTES (12 * sizeof(Tween))
+// Frame, tween, statistics, blink, idle, confused and laugh timers
+#define ROBOEYES_TIMER_BYTES (8 * sizeof(unsigned long))
+// Screen size and offsets, frame interval, flush counters, half-lifes, animation intervals and
+// durations, the easings and the catch-up limit
+#define ROBOEYES_SETTING_BYTES (17 * sizeof(int) + 5)
+// Lit and unflushed areas, the window of a frame in transfer
+#define ROBOEYES_FLUSH_BYTES (8 * sizeof(int16_t) + 3 * sizeof(uint16_t) + 3)
+// Frame and interval counts, fps and jitter
+#define ROBOEYES_STATS_BYTES (2 * sizeof(uint16_t) + 2 * sizeof(float))
+// 23 state, mood and animation bits in 4 bitfield bytes
+#define ROBOEYES_FLAG_BYTES 4
+// Time source and random state
+#define ROBOEYES_CLOCK_BYTES (sizeof(RoboEyesClock) + sizeof(uint32_t))
+// Alignment the compiler inserts: each eye pads its geometry to the alignment of its tweens, the odd
+// private bytes take one more in front of the first public int and the eyelid bytes one in front of
+// the space between.
+// None on AVR, where every type is byte aligned.
+#define ROBOEYES_EYE_PADDING ((alignof(Tween) - (6 * sizeof(EyeSize) + 3 + 6 * sizeof(int16_t)) % alignof(Tween)) % alignof(Tween))
+#define ROBOEYES_STATE_PADDING (2 * ROBOEYES_EYE_PADDING + (alignof(int) > 1 ? 2 : 0))
+
+// The budget is every part plus the padding, nothing more: 400 bytes on 64-bit hosts, 364 on ESP32
+// and 320 on AVR (408, 372 and 332 with ROBOEYES_LARGE_SCREEN). Define it higher to add fields
+// without listing them.
+#ifndef ROBOEYES_STATE_BUDGET
+#define ROBOEYES_STATE_BUDGET (ROBOEYES_GEOMETRY_BYTES + ROBOEYES_TWEEN_BYTES + ROBOEYES_TIMER_BYTES + ROBOEYES_SETTING_BYTES + \
+                               ROBOEYES_FLUSH_BYTES + ROBOEYES_STATS_BYTES + ROBOEYES_FLAG_BYTES + ROBOEYES_CLOCK_BYTES + ROBOEYES_STATE_PADDING)
+#endif
+#ifdef ROBOEYES_PROFILE
+#define ROBOEYES_PROFILE_BYTES sizeof(RoboEyesProfile)
+#else
+#define ROBOEYES_PROFILE_BYTES 0
+#endif
+static_assert(sizeof(RoboEyes) - sizeof(EyeShapeCache) - sizeof(RoboEyesDisplay) - ROBOEYES_PROFILE_BYTES <= ROBOEYES_STATE_BUDGET,
+              "RoboEyes state grew past ROBOEYES_STATE_BUDGET");
+
+#endif
@@ -0,0 +1,153 @@
+#include "RoboEyesAsync.hpp"
+
+#if defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)
+
+#include <stdlib.h>
+
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+RoboEyesAsyncDisplay::RoboEyesAsyncDisplay(const RoboEyesDisplay& target, AsyncPolicy policy)
+    : framesSent(0),
+      target(target),
+      policy(policy),
+      posted(0),
+      done(0),
+      stopping(false)
+#ifdef ARDUINO
+      ,
+      stopped(false)
+#endif
+{
+}
+
+RoboEyesAsyncDisplay::~RoboEyesAsyncDisplay() {
+    stopping = true;
+#ifdef ARDUINO
+    if (worker) {
+        xTaskNotifyGive(worker);
+        while (!stopped) {
+            pause();
+        }
+    }
+#else
+    if (worker.joinable()) {
+        wakeWorker();
+        worker.join();
+    }
+#endif
+    free(back);
+    for (uint8_t* slot : slots) {
+        free(slot);
+    }
+}
+
+bool RoboEyesAsyncDisplay::begin() {
+    if (target.flush == nullptr || target.width <= 0 || target.height <= 0) {
+        return false;
+    }
+    const size_t size = target.width * ((target.height + 7) / 8);
+    back = (uint8_t*)calloc(size, 1);
+    if (!back) {
+        return false;
+    }
+    for (uint8_t*& slot : slots) {
+        slot = (uint8_t*)calloc(size, 1);
+        if (!slot) {
+            return false;
+        }
+    }
+#ifdef ARDUINO
+    return xTaskCreatePinnedToCore(task, "RoboEyesAsync", ROBOEYES_ASYNC_STACK, this, 1, &worker, ROBOEYES_ASYNC_CORE) == pdPASS;
+#else
+    worker = std::thread(&RoboEyesAsyncDisplay::run, this);
+    return true;
+#endif
+}
+
+RoboEyesDisplay RoboEyesAsyncDisplay::display() {
+    return {back, target.width, target.height, this, flush, nullptr, false};
+}
+
+bool RoboEyesAsyncDisplay::idle() const {
+    return posted.load(std::memory_order_acquire) == done.load(std::memory_order_acquire);
+}
+
+uint16_t RoboEyesAsyncDisplay::flush(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+    RoboEyesAsyncDisplay& self = *static_cast<RoboEyesAsyncDisplay*>(context);
+
+    const uint8_t capacity = self.policy == ASYNC_DROP ? 1 : SLOTS;
+    const uint8_t next = self.posted.load(std::memory_order_relaxed);
+    while ((uint8_t)(next - self.done.load(std::memory_order_acquire)) >= capacity) {
+        if (self.policy == ASYNC_DROP) {
+            self.framesDeferred++;
+            return 0;  // RoboEyes keeps the window and offers it again with the next frame
+        }
+        self.pause();
+    }
+
+    // The worker is done with this front buffer, it only ever reads the window of its job
+    const uint8_t slot = next % SLOTS;
+    roboEyesCopyWindow(self.slots[slot], self.target.width, data, stride, page0, page1, col0, col1);
+    self.jobs[slot] = {page0, page1, col0, col1};
+    self.posted.store(next + 1, std::memory_order_release);
+    self.framesQueued++;
+    self.wakeWorker();
+    return (page1 - page0 + 1) * (col1 - col0 + 1);
+}
+
+void RoboEyesAsyncDisplay::run() {
+    while (!stopping) {
+        sleepUntilPosted();
+        uint8_t current = done.load(std::memory_order_relaxed);
+        while (current != posted.load(std::memory_order_acquire)) {
+            const uint8_t slot = current % SLOTS;
+            const Job_s job = jobs[slot];
+            target.flush(target.context, slots[slot] + job.page0 * target.width, target.width, job.page0, job.page1, job.col0, job.col1);
+            framesSent++;
+            done.store(++current, std::memory_order_release);
+        }
+    }
+}
+
+#ifdef ARDUINO
+
+void RoboEyesAsyncDisplay::task(void* self) {
+    RoboEyesAsyncDisplay& display = *static_cast<RoboEyesAsyncDisplay*>(self);
+    display.run();
+    display.stopped = true;
+    vTaskDelete(nullptr);
+}
+
+void RoboEyesAsyncDisplay::wakeWorker() {
+    xTaskNotifyGive(worker);
+}
+
+void RoboEyesAsyncDisplay::sleepUntilPosted() {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // a notification given before is not lost
+}
+
+void RoboEyesAsyncDisplay::pause() {
+    vTaskDelay(1);
+}
+
+#else
+
+void RoboEyesAsyncDisplay::wakeWorker() {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wake.notify_one();
+}
+
+void RoboEyesAsyncDisplay::sleepUntilPosted() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wake.wait(lock, [this] { return stopping || posted.load(std::memory_order_acquire) != done.load(std::memory_order_relaxed); });
+}
+
+void RoboEyesAsyncDisplay::pause() {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+#endif  // ARDUINO
+
+#endif  // ARDUINO_ARCH_ESP32 || !ARDUINO
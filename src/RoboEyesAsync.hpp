@@ -0,0 +1,117 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Double buffered display wrapper, sends frames from a worker on the other ESP32 core or a host thread.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_ASYNC_HPP
+#define _ROBOEYES_ASYNC_HPP
+
+// Needs a second core or thread: ESP32 with FreeRTOS, or a host build
+#if defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)
+
+#include <stdint.h>
+
+#include <atomic>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "RoboEyesDisplay.hpp"
+
+// Core and stack size of the ESP32 worker task, the Arduino loop runs on core 1
+#ifndef ROBOEYES_ASYNC_CORE
+#define ROBOEYES_ASYNC_CORE 0
+#endif
+#ifndef ROBOEYES_ASYNC_STACK
+#define ROBOEYES_ASYNC_STACK 4096
+#endif
+
+// What a flush does while the worker is still sending
+enum AsyncPolicy : uint8_t {
+    ASYNC_DROP,   // one frame in flight, newer ones are turned away and RoboEyes offers the latest state again
+    ASYNC_QUEUE,  // one more frame waits behind the one in flight, update() blocks only if both are taken
+};
+
+// Wraps another display: RoboEyes draws into a back buffer, every flush copies the changed
+// window into a free front buffer and hands it to the worker, which sends it to the wrapped
+// display. update() then only pays for that copy. The bus of the wrapped display belongs to
+// the worker, don't use it from the sketch while RoboEyes runs.
+class RoboEyesAsyncDisplay {
+   public:
+    RoboEyesAsyncDisplay(const RoboEyesDisplay& target, AsyncPolicy policy = ASYNC_DROP);
+    ~RoboEyesAsyncDisplay();
+
+    // Allocate the buffers and start the worker, before constructing the RoboEyes that uses it.
+    // False if out of memory, or if target can't take flushes from a page buffer.
+    bool begin();
+
+    // Display to construct RoboEyes with
+    RoboEyesDisplay display();
+
+    // True once every frame handed to the worker is sent
+    bool idle() const;
+
+    unsigned long framesQueued = 0;          // frames handed to the worker
+    unsigned long framesDeferred = 0;        // flushes turned away while busy (ASYNC_DROP)
+    std::atomic<unsigned long> framesSent;  // frames the worker finished sending
+
+   private:
+    static constexpr uint8_t SLOTS = 2;  // front buffers
+
+    struct Job_s {
+        uint16_t page0;
+        uint16_t page1;
+        uint16_t col0;
+        uint16_t col1;
+    };
+
+    RoboEyesDisplay target;
+    AsyncPolicy policy;
+    uint8_t* back = nullptr;
+    uint8_t* slots[SLOTS] = {};
+    Job_s jobs[SLOTS] = {};
+
+    // Hand-over counters, only the producer writes posted and only the worker writes done.
+    // posted - done is the number of front buffers in use.
+    std::atomic<uint8_t> posted;
+    std::atomic<uint8_t> done;
+    std::atomic<bool> stopping;
+
+#ifdef ARDUINO
+    TaskHandle_t worker = nullptr;
+    std::atomic<bool> stopped;
+    static void task(void* self);
+#else
+    std::thread worker;
+    std::mutex wakeMutex;  // only to sleep on, the hand-over itself is lock-free
+    std::condition_variable wake;
+#endif
+
+    static uint16_t flush(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1);
+    void run();
+    void wakeWorker();
+    void sleepUntilPosted();
+    void pause();
+};
+
+#endif  // ARDUINO_ARCH_ESP32 || !ARDUINO
+
+#endif
@@ -0,0 +1,137 @@
+#include "RoboEyesBatch.hpp"
+
+#ifndef ARDUINO
+
+#include <algorithm>
+#include <thread>
+
+RoboEyesBatch::RoboEyesBatch(size_t faces, int16_t width, int16_t height)
+    : faceCount(faces),
+      width(width),
+      height(height),
+      changed(faces) {
+    // Same layout as a fresh RoboEyes once its eyes are open
+    const int16_t x = (width - (EYE_WIDTH + EYE_SPACE_BETWEEN + EYE_WIDTH)) / 2;
+    const int16_t y = (height - EYE_HEIGHT) / 2;
+    const int16_t initial[BATCH_CHANNELS] = {
+        EYE_WIDTH, EYE_WIDTH, EYE_HEIGHT, EYE_HEIGHT, EYE_BORDER_RADIUS, EYE_BORDER_RADIUS,
+        x, (int16_t)(x + EYE_WIDTH + EYE_SPACE_BETWEEN), y, y, 0, 0, 0};
+    for (uint8_t c = 0; c < BATCH_CHANNELS; c++) {
+        values[c].assign(faces, (int32_t)initial[c] * 256);
+        targets[c].assign(faces, initial[c]);
+    }
+    heightDefaults[0].assign(faces, EYE_HEIGHT);
+    heightDefaults[1].assign(faces, EYE_HEIGHT);
+    setHalfLifes(20, 20, 20, 20);
+}
+
+void RoboEyesBatch::setTarget(size_t face, BatchChannel channel, int16_t target) {
+    targets[channel][face] = target;
+}
+
+void RoboEyesBatch::setHeight(size_t face, int16_t leftEye, int16_t rightEye) {
+    targets[BATCH_HEIGHT_L][face] = leftEye;
+    targets[BATCH_HEIGHT_R][face] = rightEye;
+    heightDefaults[0][face] = leftEye;
+    heightDefaults[1][face] = rightEye;
+}
+
+int16_t RoboEyesBatch::get(size_t face, BatchChannel channel) const {
+    return (values[channel][face] + 128) >> 8;
+}
+
+void RoboEyesBatch::setHalfLifes(unsigned int size, unsigned int position, unsigned int radius, unsigned int eyelids) {
+    for (uint8_t c = 0; c < BATCH_CHANNELS; c++) {
+        if (c <= BATCH_HEIGHT_R) {
+            halfLifes[c] = size;
+        } else if (c <= BATCH_RADIUS_R) {
+            halfLifes[c] = radius;
+        } else if (c <= BATCH_Y_R) {
+            halfLifes[c] = position;
+        } else {
+            halfLifes[c] = eyelids;
+        }
+    }
+}
+
+size_t RoboEyesBatch::step(unsigned long elapsed) {
+    std::fill(changed.begin(), changed.end(), 0);
+    const size_t faces = faceCount;  // stores through moved may alias the member, a local keeps the loop countable
+
+    for (uint8_t c = 0; c < BATCH_CHANNELS; c++) {
+        // Same arithmetic as Tween with EASE_EXPONENTIAL, the factor is shared by the whole channel
+        const int32_t remaining = Tween::exponentialRemaining(elapsed, halfLifes[c]) >> 4;
+        const int32_t lowest = c >= BATCH_X_L && c <= BATCH_Y_R ? INT32_MIN : 0;
+        int32_t* value = values[c].data();
+        const int16_t* target = targets[c].data();
+        uint8_t* moved = changed.data();
+
+        // Branch free, so it compiles to SIMD at -O3
+        for (size_t i = 0; i < faces; i++) {
+            const int32_t end = (int32_t)target[i] * 256;
+            const int32_t offset = (value[i] - end) * remaining >> 12;
+            int32_t next = offset < 128 && offset > -128 ? end : end + offset;  // land within half a pixel
+            next = next < lowest ? lowest : next;
+            moved[i] |= next != value[i];
+            value[i] = next;
+        }
+    }
+
+    size_t moving = 0;
+    for (uint8_t m : changed) {
+        moving += m;
+    }
+    return moving;
+}
+
+void RoboEyesBatch::render(size_t face, uint8_t* buffer) const {
+    EyeShapeCache cache;
+    renderFace(face, buffer, cache);
+}
+
+void RoboEyesBatch::renderAll(uint8_t* buffers, unsigned int threads) const {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min((size_t)threads, std::max(faceCount, (size_t)1));
+    if (threads == 1) {
+        renderRange(0, faceCount, buffers);
+        return;
+    }
+
+    // Faces don't share anything but the read-only state, each thread takes a contiguous range
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        const size_t first = faceCount * t / threads;
+        const size_t last = faceCount * (t + 1) / threads;
+        workers.emplace_back(&RoboEyesBatch::renderRange, this, first, last, buffers);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void RoboEyesBatch::renderRange(size_t first, size_t last, uint8_t* buffers) const {
+    EyeShapeCache cache;  // faces of a batch mostly share a few shapes
+    for (size_t i = first; i < last; i++) {
+        renderFace(i, buffers + i * frameBytes(), cache);
+    }
+}
+
+void RoboEyesBatch::renderFace(size_t i, uint8_t* buffer, EyeShapeCache& cache) const {
+    const uint8_t tired = get(i, BATCH_TIRED);
+    const uint8_t angry = get(i, BATCH_ANGRY);
+    const uint8_t happy = get(i, BATCH_HAPPY);
+    EyeShape left(get(i, BATCH_X_L), get(i, BATCH_Y_L), get(i, BATCH_WIDTH_L), get(i, BATCH_HEIGHT_L), get(i, BATCH_RADIUS_L),
+                  tired, angry, happy, heightDefaults[0][i], false);
+    EyeShape right(get(i, BATCH_X_R), get(i, BATCH_Y_R), get(i, BATCH_WIDTH_R), get(i, BATCH_HEIGHT_R), get(i, BATCH_RADIUS_R),
+                   tired, angry, happy, heightDefaults[1][i], true);
+    cache.beginFrame();
+    cache.attach(left);
+    if (!right.useMirrorOf(left)) {
+        cache.attach(right);
+    }
+    PageRaster(buffer, width, height).composeEyes(left, right, 0, 0, width, height);
+}
+
+#endif  // ARDUINO
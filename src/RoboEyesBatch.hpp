@@ -0,0 +1,101 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Host only: steps the transitions of many eye pairs at once and renders them in parallel.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_BATCH_HPP
+#define _ROBOEYES_BATCH_HPP
+
+#ifndef ARDUINO
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "RoboEyes.hpp"
+
+// Animated values of one face, i.e. one eye pair
+enum BatchChannel : uint8_t {
+    BATCH_WIDTH_L,
+    BATCH_WIDTH_R,
+    BATCH_HEIGHT_L,
+    BATCH_HEIGHT_R,
+    BATCH_RADIUS_L,
+    BATCH_RADIUS_R,
+    BATCH_X_L,
+    BATCH_X_R,
+    BATCH_Y_L,
+    BATCH_Y_R,
+    BATCH_TIRED,  // eyelid heights, as eyelidsTiredHeight etc. in RoboEyes
+    BATCH_ANGRY,
+    BATCH_HAPPY,
+    BATCH_CHANNELS
+};
+
+// Preview renderer for scripted sequences: the script sets targets, the batch moves every value
+// of every face towards its target like RoboEyes does with EASE_EXPONENTIAL, and draws the frames.
+// Each channel lives in its own array, so step() is one tight loop per channel that the
+// compiler vectorizes. Moods, macro animations and timers stay with the script.
+class RoboEyesBatch {
+   public:
+    // faces open eye pairs in the default position of a width x height screen
+    RoboEyesBatch(size_t faces, int16_t width, int16_t height);
+
+    size_t size() const { return faceCount; }
+
+    // Bytes of one rendered frame, width * pages
+    size_t frameBytes() const { return width * ((height + 7) / 8); }
+
+    void setTarget(size_t face, BatchChannel channel, int16_t target);
+
+    // Eye heights of face, as RoboEyes::setHeight(): targets BATCH_HEIGHT_L/R and the default height
+    // the happy eyelids follow. A blink only sets the targets.
+    void setHeight(size_t face, int16_t leftEye, int16_t rightEye);
+
+    // Current value, rounded to pixels
+    int16_t get(size_t face, BatchChannel channel) const;
+
+    // Milliseconds to get halfway, as RoboEyes::setHalfLifes(). Default 20 ms each.
+    void setHalfLifes(unsigned int size, unsigned int position, unsigned int radius, unsigned int eyelids);
+
+    // Advance all faces by elapsed milliseconds, returns the number of faces that changed
+    size_t step(unsigned long elapsed);
+
+    // Draw face into a page ordered buffer of frameBytes()
+    void render(size_t face, uint8_t* buffer) const;
+
+    // Draw all faces, face i into buffers + i * frameBytes(), split over threads (0 = one per core)
+    void renderAll(uint8_t* buffers, unsigned int threads = 0) const;
+
+   private:
+    size_t faceCount;
+    int16_t width;
+    int16_t height;
+    unsigned int halfLifes[BATCH_CHANNELS];
+
+    std::vector<int32_t> values[BATCH_CHANNELS];   // 1/256 pixels
+    std::vector<int16_t> targets[BATCH_CHANNELS];  // pixels
+    std::vector<int16_t> heightDefaults[2];        // per face, left and right
+    std::vector<uint8_t> changed;                  // per face, scratch of step()
+
+    void renderRange(size_t first, size_t last, uint8_t* buffers) const;
+    void renderFace(size_t face, uint8_t* buffer, EyeShapeCache& cache) const;
+};
+
+#endif  // ARDUINO
+
+#endif
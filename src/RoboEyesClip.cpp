@@ -0,0 +1,248 @@
+#include "RoboEyesClip.hpp"
+
+#ifndef ARDUINO
+#include <stdio.h>
+#endif
+
+// Little endian 2 byte field of a clip
+static uint16_t readClipWord(const uint8_t* at) {
+    return pgm_read_byte(at) | pgm_read_byte(at + 1) << 8;
+}
+
+RoboEyesClipPlayer::RoboEyesClipPlayer(RoboEyes& eyes)
+    : eyes(eyes) {
+}
+
+bool RoboEyesClipPlayer::play(const uint8_t* clip) {
+    const RoboEyesDisplay& display = eyes.display;
+    if (!display.buffer || readClipWord(clip) != display.width || pgm_read_byte(clip + 2) > (display.height + 7) / 8) {
+        return false;
+    }
+    stop();
+    this->clip = clip;
+    next = clip + CLIP_HEADER_BYTES;
+    frame = 0;
+    startTime = eyes.getTime();
+    return true;
+}
+
+void RoboEyesClipPlayer::stop() {
+    if (!clip) {
+        return;
+    }
+    // The eyes clear whatever the clip left lit with their next frame
+    eyes.lastDrawn = eyes.lastDrawn.unite(window());
+    eyes.redraw = 1;
+    eyes.wake();
+    clip = nullptr;
+}
+
+void RoboEyesClipPlayer::update() {
+    // A frame still on its way goes out first, the eyes' update() only continues it then
+    if (!clip || eyes.flushPending()) {
+        eyes.update();
+        return;
+    }
+    const uint16_t frames = readClipWord(clip + 3);
+    const uint8_t interval = pgm_read_byte(clip + 5);
+    if (frame < frames && eyes.getTime() - startTime >= (unsigned long)frame * interval) {
+        showFrame();
+    }
+    if (frame == frames) {
+        stop();
+    }
+}
+
+RoboEyes::Rect_s RoboEyesClipPlayer::window() const {
+    return {(int16_t)readClipWord(clip + 6),
+            (int16_t)(pgm_read_byte(clip + 10) * 8),
+            (int16_t)(readClipWord(clip + 8) + 1),
+            (int16_t)(min(pgm_read_byte(clip + 11) * 8 + 8, (int)eyes.display.height))};
+}
+
+void RoboEyesClipPlayer::showFrame() {
+    const RoboEyesDisplay& display = eyes.display;
+    const uint16_t frames = readClipWord(clip + 3);
+    const uint8_t interval = pgm_read_byte(clip + 5);
+    RoboEyes::Rect_s area = {0, 0, 0, 0};
+    eyes.bytesFlushed = 0;
+
+    // The first frame replaces the eyes, clear everything they may have lit
+    if (frame == 0) {
+        area = window().unite(eyes.lastDrawn);
+        eyes.lastDrawn = area;
+        for (uint8_t page = area.y0 / 8; page <= (area.y1 - 1) / 8; page++) {
+            if (display.banded) {
+                memset(display.buffer + area.x0, BGCOLOR, area.x1 - area.x0);
+                eyes.bytesFlushed += display.flush(display.context, display.buffer, display.width, page, page, area.x0, area.x1 - 1);
+            } else {
+                memset(display.buffer + page * display.width + area.x0, BGCOLOR, area.x1 - area.x0);
+            }
+        }
+    }
+
+    // All due frames in one go, a late update() sends their changes together
+    do {
+        while (true) {
+            const uint8_t head = pgm_read_byte(next++);
+            if (head == CLIP_END_OF_FRAME) {
+                break;
+            }
+            const uint8_t page = head & ~CLIP_FILL_RUN;
+            const uint16_t col0 = readClipWord(next);
+            const uint16_t col1 = col0 + pgm_read_byte(next + 2);
+            next += 3;
+            uint8_t* row = display.banded ? display.buffer : display.buffer + page * display.width;
+            if (head & CLIP_FILL_RUN) {
+                memset(row + col0, pgm_read_byte(next++), col1 - col0 + 1);
+            } else {
+                for (uint16_t col = col0; col <= col1; col++) {
+                    row[col] = pgm_read_byte(next++);
+                }
+            }
+            // A band holds one page, each run goes out right away
+            if (display.banded) {
+                eyes.bytesFlushed += display.flush(display.context, display.buffer, display.width, page, page, col0, col1);
+            } else {
+                area = area.unite({(int16_t)col0, (int16_t)(page * 8), (int16_t)(col1 + 1), (int16_t)(page * 8 + 8)});
+            }
+        }
+        frame++;
+    } while (frame < frames && eyes.getTime() - startTime >= (unsigned long)frame * interval);
+
+    if (!display.banded) {
+        area.y1 = min(area.y1, display.height);
+        eyes.flushRect(area);
+    }
+}
+
+#ifndef ARDUINO
+
+RoboEyesClipWriter::RoboEyesClipWriter(HostFramebuffer& framebuffer, uint8_t frameMs)
+    : framebuffer(framebuffer),
+      frameMs(frameMs) {
+}
+
+void RoboEyesClipWriter::addFrame() {
+    const uint8_t* buffer = framebuffer.getBuffer();
+    frames.emplace_back(buffer, buffer + framebuffer.width() * ((framebuffer.height() + 7) / 8));
+}
+
+static void appendWord(std::vector<uint8_t>& clip, int value) {
+    clip.insert(clip.end(), {(uint8_t)value, (uint8_t)(value >> 8)});
+}
+
+// Columns first to last of one page as fill runs where at least 4 bytes repeat, literal runs between.
+// A run covers at most 256 columns.
+static void encodeSpan(std::vector<uint8_t>& clip, uint8_t page, const uint8_t* row, int first, int last) {
+    int col = first;
+    while (col <= last) {
+        int same = col;
+        while (same < last && same - col < 255 && row[same + 1] == row[col]) {
+            same++;
+        }
+        if (same - col >= 3) {
+            clip.push_back(page | CLIP_FILL_RUN);
+            appendWord(clip, col);
+            clip.insert(clip.end(), {(uint8_t)(same - col), row[col]});
+            col = same + 1;
+            continue;
+        }
+        // Literal up to where the next fill run starts
+        int end = col + 1;
+        while (end <= last && end - col < 256 &&
+               !(end + 3 <= last && row[end] == row[end + 1] && row[end] == row[end + 2] && row[end] == row[end + 3])) {
+            end++;
+        }
+        clip.push_back(page);
+        appendWord(clip, col);
+        clip.push_back(end - 1 - col);
+        clip.insert(clip.end(), row + col, row + end);
+        col = end;
+    }
+}
+
+std::vector<uint8_t> RoboEyesClipWriter::encode() const {
+    std::vector<uint8_t> clip;
+    if (frames.empty()) {
+        return clip;
+    }
+    const int width = framebuffer.width();
+    const int pages = (framebuffer.height() + 7) / 8;
+
+    // Window of every byte lit in any frame, outside of it all frames are blank
+    int col0 = width - 1;
+    int col1 = 0;
+    int page0 = pages - 1;
+    int page1 = 0;
+    for (const std::vector<uint8_t>& frame : frames) {
+        for (int page = 0; page < pages; page++) {
+            for (int col = 0; col < width; col++) {
+                if (frame[page * width + col]) {
+                    col0 = min(col0, col);
+                    col1 = max(col1, col);
+                    page0 = min(page0, page);
+                    page1 = max(page1, page);
+                }
+            }
+        }
+    }
+    if (col0 > col1) {
+        col0 = col1 = page0 = page1 = 0;  // blank clip
+    }
+
+    appendWord(clip, width);
+    clip.push_back(pages);
+    appendWord(clip, frames.size());
+    clip.push_back(frameMs);
+    appendWord(clip, col0);
+    appendWord(clip, col1);
+    clip.insert(clip.end(), {(uint8_t)page0, (uint8_t)page1});
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        for (int page = page0; page <= page1; page++) {
+            const uint8_t* row = frames[i].data() + page * width;
+            if (i == 0) {
+                encodeSpan(clip, page, row, col0, col1);
+                continue;
+            }
+            // Changed bytes, gaps of up to two unchanged ones are cheaper inside a run than a new run header
+            const uint8_t* before = frames[i - 1].data() + page * width;
+            int col = col0;
+            while (col <= col1) {
+                if (row[col] == before[col]) {
+                    col++;
+                    continue;
+                }
+                int last = col;
+                for (int next = col + 1; next <= col1 && next - last <= 3; next++) {
+                    if (row[next] != before[next]) {
+                        last = next;
+                    }
+                }
+                encodeSpan(clip, page, row, col, last);
+                col = last + 1;
+            }
+        }
+        clip.push_back(CLIP_END_OF_FRAME);
+    }
+    return clip;
+}
+
+bool RoboEyesClipWriter::writeSource(const char* path, const char* name) const {
+    const std::vector<uint8_t> clip = encode();
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "// Baked by roboeyes_bake: %zu frames of %u ms on %dx%d, %zu bytes\n\n",
+            frames.size(), frameMs, framebuffer.width(), framebuffer.height(), clip.size());
+    fprintf(file, "#pragma once\n\n#include <RoboEyesClip.hpp>\n\nconst uint8_t %s[] PROGMEM = {", name);
+    for (size_t i = 0; i < clip.size(); i++) {
+        fprintf(file, i % 16 ? " 0x%02X," : "\n    0x%02X,", clip[i]);
+    }
+    fprintf(file, "\n};\n");
+    return fclose(file) == 0;
+}
+
+#endif  // ARDUINO
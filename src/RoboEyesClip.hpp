@@ -0,0 +1,103 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Plays pre-rendered animation clips, stored as frame deltas in flash, without drawing them.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_CLIP_HPP
+#define _ROBOEYES_CLIP_HPP
+
+#include "RoboEyes.hpp"
+
+#ifndef ARDUINO
+#include <vector>
+#endif
+
+// Clip layout, all single bytes unless noted, columns and the frame count take 2 bytes, little endian:
+//
+//   header   width, pages, frame count, frame interval in ms,
+//            window first column, last column, first page, last page
+//   frames   runs of one frame, each frame ends with CLIP_END_OF_FRAME
+//   run      page | CLIP_FILL_RUN for a fill run, first column, column count - 1,
+//            then one byte repeated over the columns, or one byte per column
+//
+// The first frame holds the whole window, every later one only the bytes that changed.
+static constexpr uint8_t CLIP_HEADER_BYTES = 12;
+static constexpr uint8_t CLIP_FILL_RUN = 0x80;
+static constexpr uint8_t CLIP_END_OF_FRAME = 0xFF;
+
+// Replays a clip through the display of eyes, frame buffer bytes are copied instead of
+// rasterizing eye shapes. Its update() replaces the one of the eyes, e.g.
+//   RoboEyesClipPlayer player(eyes);
+//   player.play(blinkClip);  // from roboeyes_bake, const uint8_t blinkClip[] PROGMEM
+//   loop(): player.update();
+// Bake the clip with the geometry and mood the eyes have when it plays, it takes over the
+// screen from them and hands it back at its last frame.
+class RoboEyesClipPlayer {
+   public:
+    explicit RoboEyesClipPlayer(RoboEyes& eyes);
+
+    // Start clip with the next update(). False if it doesn't fit the display, or the display
+    // has no frame buffer or band (roboEyesGfxDisplay).
+    bool play(const uint8_t* clip);
+
+    // Hand the screen back to the eyes right away
+    void stop();
+
+    bool isPlaying() const { return clip != nullptr; }
+
+    // Send the frames that are due while a clip plays, else the eyes' update()
+    void update();
+
+   private:
+    RoboEyes& eyes;
+    const uint8_t* clip = nullptr;
+    const uint8_t* next = nullptr;  // run of the next frame
+    uint16_t frame = 0;             // next frame
+    unsigned long startTime = 0;
+
+    // Columns and pages the clip may light
+    RoboEyes::Rect_s window() const;
+
+    void showFrame();
+};
+
+#ifndef ARDUINO
+
+// Host only: records frames from a HostFramebuffer and encodes them as a clip, see extras/host/RoboEyesBake.cpp
+class RoboEyesClipWriter {
+   public:
+    RoboEyesClipWriter(HostFramebuffer& framebuffer, uint8_t frameMs);
+
+    // Take the current content of the frame buffer as the next frame
+    void addFrame();
+
+    size_t size() const { return frames.size(); }
+
+    // The clip, empty without frames
+    std::vector<uint8_t> encode() const;
+
+    // Source file with the clip as const uint8_t name[] PROGMEM, false if it can't be written
+    bool writeSource(const char* path, const char* name) const;
+
+   private:
+    HostFramebuffer& framebuffer;
+    uint8_t frameMs;
+    std::vector<std::vector<uint8_t>> frames;
+};
+
+#endif  // ARDUINO
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Display interface of RoboEyes, adapters for concrete display libraries live in their own headers.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_DISPLAY_HPP
+#define _ROBOEYES_DISPLAY_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+// Where RoboEyes draws to. The eyes are rasterized straight into `buffer` (SSD1306 page order,
+// see PageRaster), only the finished window of changed pages and columns goes through `flush`.
+// Displays without such a buffer set it to nullptr and draw through `fillColumn` instead.
+//
+// Adapters:
+//   roboEyesDisplay(Adafruit_SSD1306&)    RoboEyesSSD1306.hpp, partial I2C transfers
+//   roboEyesDisplay(Adafruit_SH110X&)     RoboEyesSH110X.hpp, SH1106G and SH1107
+//   roboEyesPageDisplay(display)          any display with a page ordered getBuffer() and display()
+//   roboEyesGfxDisplay(display)           any Adafruit_GFX display, drawn column by column
+//   RoboEyesSSD1306Wire                   RoboEyesSSD1306Wire.hpp, banded, no frame buffer at all
+//   RoboEyesAsyncDisplay                  RoboEyesAsync.hpp, wraps another one and flushes in the background
+struct RoboEyesDisplay {
+    uint8_t* buffer;  // width * ((height + 7) / 8) bytes, or nullptr
+    int16_t width;
+    int16_t height;
+    void* context;  // handed back to the callbacks, usually the display object
+
+    // Send pages page0..page1 and columns col0..col1 (all inclusive) to the panel. data points to
+    // page0 of a page ordered buffer with stride bytes per page, not necessarily `buffer`.
+    // Returns the number of frame buffer bytes sent, or 0 if the display is busy: the window is then
+    // offered again, merged with later changes, until it is taken. May be nullptr.
+    uint16_t (*flush)(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1);
+
+    // Fill rows y0..y1 (exclusive) of column x with color, only used if buffer is nullptr
+    void (*fillColumn)(void* context, int16_t x, int16_t y0, int16_t y1, uint8_t color);
+
+    // buffer holds a single page (width bytes), each page is flushed as soon as it is rendered.
+    // Such displays must not report busy unless a flush budget is set, under a budget every piece
+    // is rendered right before it is sent and ends at a page boundary.
+    bool banded;
+};
+
+// Copy a flushed window into a display's own frame buffer, unless it already is that buffer
+inline void roboEyesCopyWindow(uint8_t* buffer, int16_t width, const uint8_t* data, int16_t stride,
+                               uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+    uint8_t* row = buffer + page0 * width;
+    if (data == row && stride == width) {
+        return;
+    }
+    for (uint16_t page = page0; page <= page1; page++) {
+        memcpy(row + col0, data + col0, col1 - col0 + 1);
+        row += width;
+        data += stride;
+    }
+}
+
+// Compile time check for the members roboEyesPageDisplay() relies on
+template <class Display>
+struct RoboEyesIsPageDisplay {
+    template <class T>
+    static auto check(T* display) -> decltype(display->getBuffer(), display->display(), display->width(), display->height(), char());
+    template <class T>
+    static long check(...);
+    static constexpr bool value = sizeof(check<Display>(nullptr)) == 1;
+};
+
+template <class Display>
+uint16_t roboEyesFlushPageDisplay(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+    Display& display = *static_cast<Display*>(context);
+    roboEyesCopyWindow(display.getBuffer(), display.width(), data, stride, page0, page1, col0, col1);
+    display.display();
+    return display.width() * ((display.height() + 7) / 8);
+}
+
+// Any display with a page ordered getBuffer() and a full screen display(), e.g. Adafruit_GrayOLED based ones
+template <class Display>
+RoboEyesDisplay roboEyesPageDisplay(Display& display) {
+    static_assert(RoboEyesIsPageDisplay<Display>::value, "roboEyesPageDisplay() needs getBuffer(), display(), width() and height()");
+    return {display.getBuffer(), (int16_t)display.width(), (int16_t)display.height(), &display, roboEyesFlushPageDisplay<Display>, nullptr, false};
+}
+
+// Compile time check for a display() member, which plain Adafruit_GFX displays may not have
+template <class Display>
+struct RoboEyesHasDisplayCall {
+    template <class T>
+    static auto check(T* display) -> decltype(display->display(), char());
+    template <class T>
+    static long check(...);
+    static constexpr bool value = sizeof(check<Display>(nullptr)) == 1;
+};
+
+template <class Display, bool = RoboEyesHasDisplayCall<Display>::value>
+struct RoboEyesGfxFlush {
+    static uint16_t flush(void* context, const uint8_t*, int16_t, uint16_t, uint16_t, uint16_t, uint16_t) {
+        Display& display = *static_cast<Display*>(context);
+        display.display();
+        return display.width() * ((display.height() + 7) / 8);
+    }
+};
+
+template <class Display>
+struct RoboEyesGfxFlush<Display, false> {
+    static constexpr uint16_t (*flush)(void*, const uint8_t*, int16_t, uint16_t, uint16_t, uint16_t, uint16_t) = nullptr;  // drawing goes straight to the panel
+};
+
+template <class Display>
+void roboEyesFillColumnGfx(void* context, int16_t x, int16_t y0, int16_t y1, uint8_t color) {
+    static_cast<Display*>(context)->drawFastVLine(x, y0, y1 - y0, color);
+}
+
+// Fallback for any Adafruit_GFX display, including ones without a page ordered buffer:
+// every column is drawn with drawFastVLine(), display() is called if the display has one
+template <class Display>
+RoboEyesDisplay roboEyesGfxDisplay(Display& display) {
+    return {nullptr, (int16_t)display.width(), (int16_t)display.height(), &display, RoboEyesGfxFlush<Display>::flush, roboEyesFillColumnGfx<Display>, false};
+}
+
+#endif
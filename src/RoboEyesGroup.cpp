@@ -0,0 +1,109 @@
+#include "RoboEyesGroup.hpp"
+
+#include <limits.h>
+
+RoboEyesGroup::RoboEyesGroup(SelectChannel select)
+    : select(select) {
+}
+
+bool RoboEyesGroup::add(RoboEyes& eyes, uint8_t channel) {
+    if (count >= ROBOEYES_GROUP_MAX) {
+        return false;
+    }
+    eyes.setClock(clock);
+    members[count++] = {&eyes, channel, false, 0, 0};
+    return true;
+}
+
+void RoboEyesGroup::setBandwidth(unsigned long bytesPerSecond, unsigned int sliceBytes) {
+    this->bytesPerSecond = bytesPerSecond;
+    this->sliceBytes = sliceBytes;
+    credit = 0;
+    refillTimer = clock();
+}
+
+void RoboEyesGroup::setClock(RoboEyesClock clock) {
+    this->clock = clock;
+    for (uint8_t i = 0; i < count; i++) {
+        members[i].eyes->setClock(clock);
+    }
+    refillTimer = clock();
+    fpsTimer = refillTimer;
+}
+
+void RoboEyesGroup::update() {
+    bytesFlushed = 0;
+    if (count == 0) {
+        return;
+    }
+    refill();
+
+    for (uint8_t i = 0; i < count; i++) {
+        Member_s& member = members[(next + i) % count];
+
+        unsigned int budget = sliceBytes;
+        if (bytesPerSecond) {
+            if (credit < 1000) {
+                break;  // bus used up, the others start the next update()
+            }
+            const unsigned long available = min(credit / 1000, (long)UINT16_MAX);
+            if (budget == 0 || available < budget) {
+                budget = available;
+            }
+        }
+
+        if (select && member.channel != selected) {
+            select(member.channel);
+            selected = member.channel;
+        }
+        member.eyes->setFlushBudget(budget);
+        member.eyes->update();
+
+        if (member.eyes->lastUpdateDrew()) {
+            member.sending = true;
+        }
+        // Complete once the last piece went out. A busy display takes nothing, the frame is then
+        // offered again by the following updates and only counts when it is taken.
+        if (member.sending && !member.eyes->flushPending() && member.eyes->bytesFlushed) {
+            member.sending = false;
+            member.frames++;
+        }
+        bytesFlushed += member.eyes->bytesFlushed;
+        credit -= (long)member.eyes->bytesFlushed * 1000;
+    }
+    next = (next + 1) % count;  // no member always goes first
+
+    measure();
+}
+
+float RoboEyesGroup::getFps(uint8_t index) const {
+    return index < count ? members[index].fps : 0;
+}
+
+void RoboEyesGroup::refill() {
+    const unsigned long now = clock();
+    unsigned long elapsed = now - refillTimer;
+    refillTimer = now;
+    if (bytesPerSecond == 0) {
+        return;
+    }
+
+    // Unused bandwidth is saved up for at most 100 ms, or one slice per member if that is more.
+    // Summed in 64 bits, with a 32 bit long a bus above 2 MB/s would overflow within a second.
+    int64_t burst = max((int64_t)bytesPerSecond * 100, (int64_t)sliceBytes * count * 1000);
+    burst = min(burst, (int64_t)LONG_MAX);
+    elapsed = min(elapsed, 1000UL);
+    credit = (long)min((int64_t)credit + (int64_t)elapsed * (int64_t)bytesPerSecond, burst);
+}
+
+void RoboEyesGroup::measure() {
+    const unsigned long now = clock();
+    if (now - fpsTimer < 1000) {
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        members[i].fps = members[i].frames * 1000.0f / (now - fpsTimer);
+        members[i].frames = 0;
+    }
+    fpsTimer = now;
+}
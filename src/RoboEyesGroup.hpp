@@ -0,0 +1,90 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Runs several RoboEyes on one bus, interleaving their transfers within a shared bandwidth.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_GROUP_HPP
+#define _ROBOEYES_GROUP_HPP
+
+#include "RoboEyes.hpp"
+
+// Most displays one group can hold
+#ifndef ROBOEYES_GROUP_MAX
+#define ROBOEYES_GROUP_MAX 4
+#endif
+
+// Owns the update() calls of its members: each group update() visits them round robin and hands
+// every member a slice of the bytes the bus may carry, so frames go out in turns instead of one
+// display holding the bus for a whole frame. The group sets the members' flushBudget.
+//
+// Displays behind a TCA9548A or similar mux get a channel, select() is called whenever the next
+// member sits on another channel. Select the channel yourself while constructing a RoboEyes,
+// the constructor already clears its display.
+class RoboEyesGroup {
+   public:
+    // Switch the bus to channel, e.g. write 1 << channel to a TCA9548A
+    typedef void (*SelectChannel)(uint8_t channel);
+
+    RoboEyesGroup(SelectChannel select = nullptr);
+
+    // Add a display, it takes the clock of the group. False if the group is full.
+    bool add(RoboEyes& eyes, uint8_t channel = 0);
+
+    // Bytes all members together may send per second (0 = no limit, the default), and the most
+    // one member sends per turn (0 = whole frames). Defaults to 128, one SSD1306 page row.
+    void setBandwidth(unsigned long bytesPerSecond, unsigned int sliceBytes = 128);
+
+    // Time source of the group and its members, millis() by default. Bus share, frame rates and
+    // the members' frames all run on this one clock.
+    void setClock(RoboEyesClock clock);
+
+    // Call as often as possible instead of the members' update()
+    void update();
+
+    uint8_t size() const { return count; }
+
+    // Frames per second member index completed (drawn and fully sent), measured over the last second
+    float getFps(uint8_t index) const;
+
+    unsigned long bytesFlushed = 0;  // bytes sent by all members during the last update()
+
+   private:
+    struct Member_s {
+        RoboEyes* eyes;
+        uint8_t channel;
+        bool sending;        // a frame was drawn and isn't completely sent yet
+        unsigned int frames;  // completed in the current measuring window
+        float fps;
+    };
+
+    Member_s members[ROBOEYES_GROUP_MAX];
+    uint8_t count = 0;
+    uint8_t next = 0;  // member to get the first turn of the next update()
+    SelectChannel select;
+    RoboEyesClock clock = millis;
+    int16_t selected = -1;  // channel the bus is switched to, -1 = unknown
+
+    unsigned long bytesPerSecond = 0;
+    unsigned int sliceBytes = 128;
+    long credit = 0;  // bytes the bus may still carry, in 1/1000 bytes
+    unsigned long refillTimer = 0;
+    unsigned long fpsTimer = 0;
+
+    void refill();
+    void measure();
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef ARDUINO
+
+#include "RoboEyesHost.hpp"
+
+#include <stdio.h>
+
+#include <chrono>
+
+//*********************************************************************************************
+//  ARDUINO CORE
+//*********************************************************************************************
+
+static unsigned long hostMillis = 0;
+static uint32_t hostRandomState = 1;
+
+unsigned long millis() {
+    return hostMillis;
+}
+
+unsigned long micros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void roboEyesHostSetMillis(unsigned long ms) {
+    hostMillis = ms;
+}
+
+void roboEyesHostAdvanceMillis(unsigned long ms) {
+    hostMillis += ms;
+}
+
+// xorshift32, same sequence on every host
+long random(long howbig) {
+    if (howbig <= 0) {
+        return 0;
+    }
+    hostRandomState ^= hostRandomState << 13;
+    hostRandomState ^= hostRandomState >> 17;
+    hostRandomState ^= hostRandomState << 5;
+    return hostRandomState % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) {
+        hostRandomState = seed;
+    }
+}
+
+//*********************************************************************************************
+//  FRAME BUFFER
+//*********************************************************************************************
+
+HostFramebuffer::HostFramebuffer(int16_t width, int16_t height)
+    : buffer(width * ((height + 7) / 8)),
+      band(width),
+      w(width),
+      h(height) {
+}
+
+bool HostFramebuffer::getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || y < 0 || x >= w || y >= h) {
+        return false;
+    }
+    return buffer[(y / 8) * w + x] & (1 << (y & 7));
+}
+
+bool HostFramebuffer::writePBM(const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P4\n%d %d\n", w, h);
+    for (int16_t y = 0; y < h; y++) {
+        // PBM rows are packed MSB first, 1 is black
+        for (int16_t x = 0; x < w; x += 8) {
+            uint8_t bits = 0;
+            for (int16_t i = 0; i < 8; i++) {
+                if (x + i >= w || !getPixel(x + i, y)) {
+                    bits |= 0x80 >> i;
+                }
+            }
+            fputc(bits, file);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length) {
+    crc = ~crc;
+    while (length--) {
+        crc ^= *data++;
+        for (uint8_t k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static void putBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+static void putChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data) {
+    putBigEndian(png, data.size());
+    const size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+    putBigEndian(png, crc32(0, png.data() + start, png.size() - start));
+}
+
+bool HostFramebuffer::writePNG(const char* path) const {
+    // Filter byte 0 and the row packed MSB first, 1 is white
+    const size_t stride = (w + 7) / 8 + 1;
+    std::vector<uint8_t> raw(stride * h);
+    for (int16_t y = 0; y < h; y++) {
+        for (int16_t x = 0; x < w; x++) {
+            if (getPixel(x, y)) {
+                raw[y * stride + 1 + x / 8] |= 0x80 >> (x & 7);
+            }
+        }
+    }
+
+    // zlib stream of stored deflate blocks, frames are tiny and no zlib is needed
+    std::vector<uint8_t> idat = {0x78, 0x01};
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+    size_t offset = 0;
+    do {
+        const size_t length = std::min(raw.size() - offset, (size_t)0xFFFF);
+        idat.push_back(offset + length == raw.size());  // final block?
+        idat.push_back(length);
+        idat.push_back(length >> 8);
+        idat.push_back(~length);
+        idat.push_back(~length >> 8);
+        for (size_t i = offset; i < offset + length; i++) {
+            idat.push_back(raw[i]);
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        offset += length;
+    } while (offset < raw.size());
+    putBigEndian(idat, (adlerB << 16) | adlerA);
+
+    std::vector<uint8_t> ihdr;
+    putBigEndian(ihdr, w);
+    putBigEndian(ihdr, h);
+    ihdr.insert(ihdr.end(), {1, 0, 0, 0, 0});  // 1 bit grayscale, no interlace
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    putChunk(png, "IHDR", ihdr);
+    putChunk(png, "IDAT", idat);
+    putChunk(png, "IEND", {});
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = fwrite(png.data(), 1, png.size(), file) == png.size();
+    return fclose(file) == 0 && written;
+}
+
+static uint16_t flushHostFramebuffer(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+    HostFramebuffer& framebuffer = *static_cast<HostFramebuffer*>(context);
+    roboEyesCopyWindow(framebuffer.getBuffer(), framebuffer.width(), data, stride, page0, page1, col0, col1);
+    const uint16_t bytes = (page1 - page0 + 1) * (col1 - col0 + 1);
+    framebuffer.flushes++;
+    framebuffer.bytesFlushed += bytes;
+    return bytes;
+}
+
+RoboEyesDisplay roboEyesDisplay(HostFramebuffer& framebuffer) {
+    return {framebuffer.getBuffer(), framebuffer.width(), framebuffer.height(), &framebuffer, flushHostFramebuffer, nullptr, false};
+}
+
+RoboEyesDisplay roboEyesBandedDisplay(HostFramebuffer& framebuffer) {
+    return {framebuffer.band.data(), framebuffer.width(), framebuffer.height(), &framebuffer, flushHostFramebuffer, nullptr, true};
+}
+
+#endif  // ARDUINO
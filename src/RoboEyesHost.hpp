@@ -0,0 +1,84 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Headless host build: stands in for the Arduino core and renders into an in-memory frame buffer.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_HOST_HPP
+#define _ROBOEYES_HOST_HPP
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "RoboEyesDisplay.hpp"
+
+// The parts of the Arduino core RoboEyes uses
+typedef uint8_t byte;
+using std::max;
+using std::min;
+
+// Flash and RAM share one address space
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+
+unsigned long millis();
+unsigned long micros();
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// millis() only moves when told to, so a run renders the same frames every time. micros() is the
+// real time for ROBOEYES_PROFILE, RoboEyes itself never reads it.
+void roboEyesHostSetMillis(unsigned long ms);
+void roboEyesHostAdvanceMillis(unsigned long ms);
+
+// 1 bit per pixel frame buffer in SSD1306 page order, standing in for the display
+class HostFramebuffer {
+   public:
+    HostFramebuffer(int16_t width, int16_t height);
+
+    uint8_t* getBuffer() { return buffer.data(); }
+    int16_t width() const { return w; }
+    int16_t height() const { return h; }
+    bool getPixel(int16_t x, int16_t y) const;
+
+    // Binary PBM (P4) and 1 bit grayscale PNG, lit pixels white as on the panel. False if the file can't be written.
+    bool writePBM(const char* path) const;
+    bool writePNG(const char* path) const;
+
+    unsigned long flushes = 0;       // flush calls, i.e. frames sent
+    unsigned long bytesFlushed = 0;  // frame buffer bytes sent over all flushes
+
+   private:
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> band;  // single page RoboEyes renders into when banded
+    int16_t w;
+    int16_t h;
+
+    friend RoboEyesDisplay roboEyesBandedDisplay(HostFramebuffer& framebuffer);
+};
+
+RoboEyesDisplay roboEyesDisplay(HostFramebuffer& framebuffer);
+
+// Same panel, but RoboEyes renders one page at a time like on a display without a frame buffer
+RoboEyesDisplay roboEyesBandedDisplay(HostFramebuffer& framebuffer);
+
+#endif  // ARDUINO
+
+#endif
@@ -0,0 +1,80 @@
+#include "RoboEyesProfile.hpp"
+
+#ifdef ROBOEYES_PROFILE
+
+uint32_t RoboEyesProfile::get(uint8_t frame, ProfilePhase phase) const {
+    if (frame >= count) {
+        return 0;
+    }
+    const uint8_t oldest = (next + ROBOEYES_PROFILE_FRAMES - count) % ROBOEYES_PROFILE_FRAMES;
+    return ring[(oldest + frame) % ROBOEYES_PROFILE_FRAMES][phase];
+}
+
+ProfileStats RoboEyesProfile::stats(ProfilePhase phase) const {
+    if (count == 0) {
+        return {0, 0, 0};
+    }
+    // Insertion sort of a copy, only done when asked and the ring is short
+    uint32_t sorted[ROBOEYES_PROFILE_FRAMES];
+    uint64_t sum = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint32_t value = ring[i][phase];
+        sum += value;
+        uint8_t j = i;
+        for (; j > 0 && sorted[j - 1] > value; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+    const uint8_t p99 = ((unsigned int)count * 99 + 99) / 100 - 1;
+    return {sorted[0], (uint32_t)(sum / count), sorted[p99]};
+}
+
+void RoboEyesProfile::reset() {
+    next = 0;
+    count = 0;
+    frames = 0;
+    late = 0;
+    dropped = 0;
+}
+
+void RoboEyesProfile::begin() {
+    frameStart = ROBOEYES_PROFILE_CLOCK();
+    lapStart = frameStart;
+    for (uint8_t phase = 0; phase < PROFILE_PHASES; phase++) {
+        current[phase] = 0;
+    }
+}
+
+void RoboEyesProfile::lap(ProfilePhase phase) {
+    const uint32_t now = ROBOEYES_PROFILE_CLOCK();
+    current[phase] += now - lapStart;
+    lapStart = now;
+}
+
+void RoboEyesProfile::end(unsigned int intervalMs) {
+    current[PROFILE_TOTAL] = (uint32_t)ROBOEYES_PROFILE_CLOCK() - frameStart;
+    for (uint8_t phase = 0; phase < PROFILE_PHASES; phase++) {
+        ring[next][phase] = current[phase];
+    }
+    next = (next + 1) % ROBOEYES_PROFILE_FRAMES;
+    if (count < ROBOEYES_PROFILE_FRAMES) {
+        count++;
+    }
+    frames++;
+    if (current[PROFILE_TOTAL] > (uint32_t)intervalMs * ROBOEYES_PROFILE_TICKS_PER_MS) {
+        late++;
+    }
+}
+
+void RoboEyesProfile::extend(ProfilePhase phase) {
+    if (count == 0) {
+        return;
+    }
+    const uint32_t ticks = (uint32_t)ROBOEYES_PROFILE_CLOCK() - frameStart;
+    uint32_t* last = ring[(next + ROBOEYES_PROFILE_FRAMES - 1) % ROBOEYES_PROFILE_FRAMES];
+    last[phase] += ticks;
+    last[PROFILE_TOTAL] += ticks;
+}
+
+#endif  // ROBOEYES_PROFILE
@@ -0,0 +1,163 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Optional frame time profiling, only built with ROBOEYES_PROFILE.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_PROFILE_HPP
+#define _ROBOEYES_PROFILE_HPP
+
+#ifdef ROBOEYES_PROFILE
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include "RoboEyesHost.hpp"
+#endif
+
+// Time source of the profile, e.g. a cycle counter for finer steps
+#ifndef ROBOEYES_PROFILE_CLOCK
+#define ROBOEYES_PROFILE_CLOCK micros
+#endif
+
+// Ticks of ROBOEYES_PROFILE_CLOCK per millisecond, to tell late frames
+#ifndef ROBOEYES_PROFILE_TICKS_PER_MS
+#define ROBOEYES_PROFILE_TICKS_PER_MS 1000
+#endif
+
+// Number of recent frames kept, each takes 4 * PROFILE_PHASES bytes
+#ifndef ROBOEYES_PROFILE_FRAMES
+#define ROBOEYES_PROFILE_FRAMES 32
+#endif
+
+static_assert(ROBOEYES_PROFILE_FRAMES > 0 && ROBOEYES_PROFILE_FRAMES <= 255, "ROBOEYES_PROFILE_FRAMES must be 1 to 255");
+
+// Where the time of a frame goes
+enum ProfilePhase : uint8_t {
+    PROFILE_TWEEN,   // transitions and eyelids
+    PROFILE_MACRO,   // apply_macro(), autoblinker, idle mode and the macro animations
+    PROFILE_RASTER,  // eye shapes into the frame buffer or band
+    PROFILE_FLUSH,   // sending to the display, including parts sent by later update() calls
+    PROFILE_TOTAL,   // the whole frame, with what lies between the phases
+    PROFILE_PHASES
+};
+
+struct ProfileStats {
+    uint32_t min;
+    uint32_t avg;
+    uint32_t p99;  // the maximum while fewer than 100 frames are kept
+};
+
+// Timings of the recent frames in a ring, plus counters since the start. RoboEyes fills it,
+// see RoboEyes::getProfile(). All times are in ticks of ROBOEYES_PROFILE_CLOCK, microseconds by default.
+class RoboEyesProfile {
+   public:
+    // Frames in the ring, up to ROBOEYES_PROFILE_FRAMES
+    uint8_t size() const { return count; }
+
+    // Time of a phase in a kept frame, 0 is the oldest
+    uint32_t get(uint8_t frame, ProfilePhase phase) const;
+
+    // Over the kept frames, all 0 without frames
+    ProfileStats stats(ProfilePhase phase) const;
+
+    // Frames drawn since the start
+    unsigned long getFrames() const { return frames; }
+
+    // Frames that took longer than the frame interval
+    unsigned long getLateFrames() const { return late; }
+
+    // Frame slots update() missed because it was called too late, settled periods don't count
+    unsigned long getDroppedFrames() const { return dropped; }
+
+    // Forget the kept frames and the counters
+    void reset();
+
+    // Table of the stats and the counters, out is e.g. Serial or anything else with print() and println()
+    template <class Output>
+    void print(Output& out) const {
+        static const char* const names[PROFILE_PHASES] = {"tween ", "macro ", "raster", "flush ", "total "};
+        out.print("phase  min avg p99 over ");
+        out.print((unsigned int)count);
+        out.println(" frames");
+        for (uint8_t phase = 0; phase < PROFILE_PHASES; phase++) {
+            const ProfileStats s = stats((ProfilePhase)phase);
+            out.print(names[phase]);
+            out.print(' ');
+            out.print((unsigned long)s.min);
+            out.print(' ');
+            out.print((unsigned long)s.avg);
+            out.print(' ');
+            out.println((unsigned long)s.p99);
+        }
+        out.print("frames ");
+        out.print(frames);
+        out.print(", late ");
+        out.print(late);
+        out.print(", dropped ");
+        out.println(dropped);
+    }
+
+   private:
+    friend class RoboEyes;
+
+    uint32_t ring[ROBOEYES_PROFILE_FRAMES][PROFILE_PHASES];
+    uint32_t current[PROFILE_PHASES];  // frame being measured
+    uint32_t frameStart = 0;
+    uint32_t lapStart = 0;
+    uint8_t next = 0;   // slot of the next frame
+    uint8_t count = 0;  // kept frames
+    unsigned long frames = 0;
+    unsigned long late = 0;
+    unsigned long dropped = 0;
+
+    // Start timing a frame
+    void begin();
+
+    // Charge the time since the last begin() or lap() to phase
+    void lap(ProfilePhase phase);
+
+    // Keep the frame, late if it took longer than intervalMs
+    void end(unsigned int intervalMs);
+
+    // Charge the time since begin() to phase of the last kept frame, for work done after it ended
+    void extend(ProfilePhase phase);
+
+    // Count missed frame slots, not before the first frame
+    void drop(unsigned long slots) {
+        if (frames) {
+            dropped += slots;
+        }
+    }
+};
+
+#define ROBOEYES_PROFILE_BEGIN(profile) (profile).begin()
+#define ROBOEYES_PROFILE_LAP(profile, phase) (profile).lap(phase)
+#define ROBOEYES_PROFILE_END(profile, intervalMs) (profile).end(intervalMs)
+#define ROBOEYES_PROFILE_EXTEND(profile, phase) (profile).extend(phase)
+#define ROBOEYES_PROFILE_DROP(profile, slots) (profile).drop(slots)
+
+#else
+
+// Compiled out, nothing is measured or stored
+#define ROBOEYES_PROFILE_BEGIN(profile) ((void)0)
+#define ROBOEYES_PROFILE_LAP(profile, phase) ((void)0)
+#define ROBOEYES_PROFILE_END(profile, intervalMs) ((void)0)
+#define ROBOEYES_PROFILE_EXTEND(profile, phase) ((void)0)
+#define ROBOEYES_PROFILE_DROP(profile, slots) ((void)(slots))
+
+#endif  // ROBOEYES_PROFILE
+
+#endif
@@ -0,0 +1,358 @@
+#include "RoboEyesRaster.hpp"
+
+#include <string.h>
+
+// Rows cut from the top and the bottom of each corner column, for every radius up to
+// ROBOEYES_MAX_RADIUS. The row of radius r holds the columns dx = 1..r, counted outwards
+// from the corner circle's center, traced with the same midpoint steps as
+// Adafruit_GFX::fillCircleHelper(). Generated at compile time, with single return constexpr
+// functions so C++11 compilers take it as well.
+static constexpr uint16_t cornerOffset(int16_t r) {
+    return r * (r - 1) / 2;  // start of the row of radius r
+}
+
+static constexpr uint8_t CORNER_EMPTY = 0xFF;  // column not reached by the circle
+
+static constexpr int16_t raiseIf(bool condition, int16_t value, int16_t extent) {
+    return condition && value > extent ? value : extent;
+}
+
+static constexpr int16_t traceCorner(int16_t dx, int16_t f, int16_t ddF_x, int16_t ddF_y, int16_t cx, int16_t cy, int16_t px, int16_t py, int16_t extent);
+
+// Second half of a midpoint step, cx and cy have moved: the new point reaches column cx,
+// and the previous row ended in column py when cy changed
+static constexpr int16_t traceCornerMoved(int16_t dx, int16_t f, int16_t ddF_x, int16_t ddF_y, int16_t cx, int16_t cy, int16_t px, int16_t py, int16_t extent) {
+    return traceCorner(dx, f, ddF_x, ddF_y, cx, cy, cx, cy != py ? cy : py,
+                       raiseIf(cy != py && py == dx, px, raiseIf(cx == dx && cx < cy + 1, cy, extent)));
+}
+
+// Half height of the quarter circle in column dx, -1 if it doesn't reach it
+static constexpr int16_t traceCorner(int16_t dx, int16_t f, int16_t ddF_x, int16_t ddF_y, int16_t cx, int16_t cy, int16_t px, int16_t py, int16_t extent) {
+    return cx >= cy ? extent
+           : f >= 0 ? traceCornerMoved(dx, f + ddF_y + 2 + ddF_x + 2, ddF_x + 2, ddF_y + 2, cx + 1, cy - 1, px, py, extent)
+                    : traceCornerMoved(dx, f + ddF_x + 2, ddF_x + 2, ddF_y, cx + 1, cy, px, py, extent);
+}
+
+static constexpr uint8_t insetOf(int16_t r, int16_t extent) {
+    return extent < 0 ? CORNER_EMPTY : r - extent;
+}
+
+// Entry i of the table, searched from the row of radius r on
+static constexpr uint8_t cornerEntry(uint16_t i, int16_t r) {
+    return r > ROBOEYES_MAX_RADIUS    ? 0
+           : i < cornerOffset(r + 1) ? insetOf(r, traceCorner(i - cornerOffset(r) + 1, 1 - r, 1, -2 * r, 0, r, 0, r, -1))
+                                     : cornerEntry(i, r + 1);
+}
+
+// Table indices 0..N-1 as a parameter pack, built by halves to keep the template depth low
+template <uint16_t... I>
+struct CornerIndices {};
+
+template <class Low, class High>
+struct JoinCornerIndices;
+
+template <uint16_t... Low, uint16_t... High>
+struct JoinCornerIndices<CornerIndices<Low...>, CornerIndices<High...>> {
+    typedef CornerIndices<Low..., (uint16_t)(sizeof...(Low) + High)...> type;
+};
+
+template <uint16_t N>
+struct MakeCornerIndices : JoinCornerIndices<typename MakeCornerIndices<N / 2>::type, typename MakeCornerIndices<N - N / 2>::type> {};
+
+template <>
+struct MakeCornerIndices<0> {
+    typedef CornerIndices<> type;
+};
+
+template <>
+struct MakeCornerIndices<1> {
+    typedef CornerIndices<0> type;
+};
+
+struct CornerTable {
+    static constexpr uint16_t SIZE = cornerOffset(ROBOEYES_MAX_RADIUS + 1) + 1;
+
+    uint8_t inset[SIZE];
+
+    template <uint16_t... I>
+    constexpr CornerTable(CornerIndices<I...>) : inset{cornerEntry(I, 1)...} {
+    }
+};
+
+static constexpr CornerTable cornerTable{MakeCornerIndices<CornerTable::SIZE>::type()};
+
+// Rows cut from top and bottom of column c of a w wide rounded rect, -1 if the column is empty
+static inline int16_t cornerInset(int16_t c, int16_t w, int16_t r, const uint8_t* corners) {
+    int16_t dx;
+    if (c < r) {
+        dx = r - c;  // left corners
+    } else if (c >= w - r) {
+        dx = c - (w - r - 1);  // right corners
+    } else {
+        return 0;
+    }
+    const uint8_t inset = corners[dx - 1];
+    return inset == CORNER_EMPTY ? -1 : inset;
+}
+
+// Radius as Adafruit_GFX::fillRoundRect() clamps it, limited to the corner tables
+static int16_t clampRadius(int16_t r, int16_t w, int16_t h) {
+    int16_t maxRadius = ((w < h) ? w : h) / 2;  // 1/2 minor axis
+    if (r > maxRadius) {
+        r = maxRadius;
+    }
+    if (r > ROBOEYES_MAX_RADIUS) {
+        r = ROBOEYES_MAX_RADIUS;
+    }
+    return r < 0 ? 0 : r;
+}
+
+// Bits of one page byte covered by rows top..bottom, relative to the page
+static inline uint8_t spanMask(int16_t top, int16_t bottom) {
+    if (top < 0) {
+        top = 0;
+    }
+    if (bottom > 8) {
+        bottom = 8;
+    }
+    if (top >= bottom) {
+        return 0;
+    }
+    return (0xFF << top) & (0xFF >> (8 - bottom));
+}
+
+//*********************************************************************************************
+//  EYE SHAPE
+//*********************************************************************************************
+
+EyeShape::EyeShape(int16_t x, int16_t y, int16_t width, int16_t height, int16_t radius,
+                   uint8_t tiredHeight, uint8_t angryHeight, uint8_t happyOffset, int16_t happyHeight, bool rightEye)
+    : x(x),
+      y(y),
+      width(width),
+      height(height),
+      key{width, height, clampRadius(radius, width, height), clampRadius(radius, width + 2, happyHeight),
+          tiredHeight, angryHeight, happyOffset, rightEye},
+      happyTop(height - happyOffset + 1),
+      corners(cornerTable.inset + cornerOffset(key.radius)),
+      happyCorners(cornerTable.inset + cornerOffset(key.happyRadius)) {
+}
+
+bool EyeShape::column(int16_t c, int16_t& top, int16_t& bottom) const {
+    int16_t t;
+    int16_t b;
+    if (spans) {
+        const int16_t i = reversed ? width - 1 - c : c;
+        t = spans[2 * i];
+        b = spans[2 * i + 1];
+        if (t >= b) {
+            return false;
+        }
+    } else if (!computeColumn(c, t, b)) {
+        return false;
+    }
+    top = y + t;
+    bottom = y + b;
+    return true;
+}
+
+void EyeShape::rasterize(uint8_t* out) const {
+    for (int16_t c = 0; c < width; c++) {
+        int16_t t;
+        int16_t b;
+        if (!computeColumn(c, t, b)) {
+            t = b = 0;
+        }
+        out[2 * c] = t;
+        out[2 * c + 1] = b;
+    }
+}
+
+void EyeShape::useSpans(const uint8_t* spans) {
+    this->spans = spans;
+    reversed = false;
+}
+
+bool EyeShape::mirrors(const EyeShape& other) const {
+    Key_s mirrored = other.key;
+    mirrored.rightEye = !mirrored.rightEye;
+    return key == mirrored;
+}
+
+bool EyeShape::useMirrorOf(const EyeShape& other) {
+    if (!other.spans || other.reversed || !mirrors(other)) {
+        return false;
+    }
+    spans = other.spans;
+    reversed = true;
+    return true;
+}
+
+bool EyeShape::computeColumn(int16_t c, int16_t& top, int16_t& bottom) const {
+    const int16_t inset = cornerInset(c, width, key.radius, corners);
+    if (inset < 0) {
+        return false;
+    }
+    int16_t t = inset;
+    int16_t b = height - inset;
+
+    // Tired lids hang lowest at the outer edge, angry lids at the inner edge.
+    // Both slope linearly to zero across the eye, mirrored for the right eye.
+    if (key.tiredHeight) {
+        const int16_t k = key.rightEye ? width - 1 - c : c;
+        const int16_t depth = (int32_t)key.tiredHeight * (width - k) / width;
+        if (depth > t) {
+            t = depth;
+        }
+    }
+    if (key.angryHeight) {
+        const int16_t k = key.rightEye ? c : width - 1 - c;
+        const int16_t depth = (int32_t)key.angryHeight * (width - k) / width;
+        if (depth > t) {
+            t = depth;
+        }
+    }
+
+    // Happy lid is a rounded rect one pixel wider on each side, pushed up from below
+    if (key.happyOffset) {
+        const int16_t happyInset = cornerInset(c + 1, width + 2, key.happyRadius, happyCorners);
+        if (happyInset >= 0 && happyTop + happyInset < b) {
+            b = happyTop + happyInset;
+        }
+    }
+
+    if (t >= b) {
+        return false;
+    }
+    top = t;
+    bottom = b;
+    return true;
+}
+
+//*********************************************************************************************
+//  SHAPE CACHE
+//*********************************************************************************************
+
+void EyeShapeCache::beginFrame() {
+#if ROBOEYES_SHAPE_CACHE_SIZE > 0
+    useCounter++;
+#endif
+}
+
+void EyeShapeCache::attach(EyeShape& shape) {
+#if ROBOEYES_SHAPE_CACHE_SIZE > 0
+    // Spans are stored as bytes, taller eyes would not fit
+    if (shape.width <= 0 || shape.width > ROBOEYES_SHAPE_CACHE_WIDTH || shape.height > 255) {
+        return;
+    }
+    Entry_s* victim = nullptr;
+    for (Entry_s& entry : entries) {
+        if (entry.lastUsed && entry.key == shape.key) {
+            entry.lastUsed = useCounter;
+            shape.useSpans(entry.spans);
+            hits++;
+            return;
+        }
+        // Least recently used, or empty. Entries of this frame are still drawn from.
+        if (entry.lastUsed != useCounter && (!victim || entry.lastUsed < victim->lastUsed)) {
+            victim = &entry;
+        }
+    }
+    misses++;
+    if (!victim) {
+        return;  // no free entry this frame, the shape computes its columns itself
+    }
+    victim->key = shape.key;
+    victim->lastUsed = useCounter;
+    shape.rasterize(victim->spans);
+    shape.useSpans(victim->spans);
+#else
+    (void)shape;
+#endif
+}
+
+//*********************************************************************************************
+//  PAGE RASTER
+//*********************************************************************************************
+
+PageRaster::PageRaster(uint8_t* buffer, int16_t width, int16_t height)
+    : buffer(buffer),
+      width(width),
+      height(height),
+      pages((height + 7) / 8) {
+}
+
+PageRaster::PageRaster(uint8_t* buffer, int16_t width, int16_t height, uint8_t firstPage, uint8_t pages)
+    : buffer(buffer),
+      width(width),
+      height(height),
+      firstPage(firstPage),
+      pages(pages) {
+}
+
+void PageRaster::clear(uint8_t color) {
+    memset(buffer, color ? 0xFF : 0x00, width * pages);
+}
+
+void PageRaster::composeEyes(const EyeShape& left, const EyeShape& right, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    if (x0 < 0) {
+        x0 = 0;
+    }
+    if (y0 < 0) {
+        y0 = 0;
+    }
+    if (x1 > width) {
+        x1 = width;
+    }
+    if (y1 > height) {
+        y1 = height;
+    }
+    if (y0 < firstPage * 8) {
+        y0 = firstPage * 8;
+    }
+    if (y1 > (firstPage + pages) * 8) {
+        y1 = (firstPage + pages) * 8;
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const int16_t page0 = y0 >> 3;
+    const int16_t page1 = (y1 - 1) >> 3;
+
+    // Clip each eye to the columns of the window up front, eyes outside of its pages are culled
+    const EyeShape* eyes[] = {&left, &right};
+    int16_t from[2];
+    int16_t to[2];
+    for (uint8_t i = 0; i < 2; i++) {
+        from[i] = to[i] = x0;
+        if (eyes[i]->overlaps(x0, page0 << 3, x1, (page1 + 1) << 3)) {
+            const int16_t right = eyes[i]->x + eyes[i]->width;
+            from[i] = eyes[i]->x > x0 ? eyes[i]->x : x0;
+            to[i] = right < x1 ? right : x1;
+        }
+    }
+
+    for (int16_t x = x0; x < x1; x++) {
+        // Each eye contributes at most one span to a column
+        int16_t tops[2];
+        int16_t bottoms[2];
+        uint8_t spans = 0;
+        for (uint8_t i = 0; i < 2; i++) {
+            if (x >= from[i] && x < to[i] && eyes[i]->column(x - eyes[i]->x, tops[spans], bottoms[spans])) {
+                spans++;
+            }
+        }
+
+        uint8_t* p = buffer + (page0 - firstPage) * width + x;
+        for (int16_t page = page0; page <= page1; page++) {
+            const int16_t row = page << 3;
+            uint8_t bits = 0;
+            for (uint8_t i = 0; i < spans; i++) {
+                bits |= spanMask(tops[i] - row, bottoms[i] - row);
+            }
+            *p = bits;
+            p += width;
+        }
+    }
+}
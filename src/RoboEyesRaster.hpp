@@ -0,0 +1,163 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Page-native rasterizer, draws straight into the frame buffer of monochrome OLED controllers.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_RASTER_HPP
+#define _ROBOEYES_RASTER_HPP
+
+#include <stdint.h>
+
+// Largest corner radius with a precomputed corner table, larger radii are drawn with this one.
+// Flash cost of the tables is ROBOEYES_MAX_RADIUS * (ROBOEYES_MAX_RADIUS + 1) / 2 bytes.
+#ifndef ROBOEYES_MAX_RADIUS
+#define ROBOEYES_MAX_RADIUS 18  // EYE_HEIGHT / 2
+#endif
+
+static_assert(ROBOEYES_MAX_RADIUS >= 0, "ROBOEYES_MAX_RADIUS can't be negative");
+
+// Rasterized eye shapes kept per RoboEyes instance, 0 disables the cache.
+// RAM cost is about ROBOEYES_SHAPE_CACHE_SIZE * (2 * ROBOEYES_SHAPE_CACHE_WIDTH + 16) bytes, 460 per
+// instance with the default 4 on ESP32. Off by default on AVR, where that is a quarter of the RAM.
+#ifndef ROBOEYES_SHAPE_CACHE_SIZE
+#ifdef __AVR__
+#define ROBOEYES_SHAPE_CACHE_SIZE 0
+#else
+#define ROBOEYES_SHAPE_CACHE_SIZE 4
+#endif
+#endif
+// Both eyes of a frame may miss, the second must not evict the spans of the first
+static_assert(ROBOEYES_SHAPE_CACHE_SIZE == 0 || ROBOEYES_SHAPE_CACHE_SIZE >= 2, "ROBOEYES_SHAPE_CACHE_SIZE must be 0 or at least 2");
+// Widest eye in pixels the cache can hold, wider eyes are rasterized every frame
+#ifndef ROBOEYES_SHAPE_CACHE_WIDTH
+#define ROBOEYES_SHAPE_CACHE_WIDTH 48
+#endif
+
+// Visible part of one eye: the rounded eye body minus the tired, angry and happy eyelids.
+// Each column is a single vertical span, since tired and angry lids only cut from the
+// top and the happy lid only cuts from the bottom.
+class EyeShape {
+   public:
+    // Everything that defines the pixels of a shape, independent of its position
+    struct Key_s {
+        int16_t width;
+        int16_t height;
+        int16_t radius;       // clamped body radius
+        int16_t happyRadius;  // clamped radius of the rounded rect cutting the happy bottom lid
+        uint8_t tiredHeight;
+        uint8_t angryHeight;
+        uint8_t happyOffset;
+        bool rightEye;
+
+        bool operator==(const Key_s& other) const {
+            return width == other.width && height == other.height && radius == other.radius && happyRadius == other.happyRadius &&
+                   tiredHeight == other.tiredHeight && angryHeight == other.angryHeight && happyOffset == other.happyOffset &&
+                   rightEye == other.rightEye;
+        }
+    };
+
+    // rightEye mirrors the slope of the tired and angry lids
+    EyeShape(int16_t x, int16_t y, int16_t width, int16_t height, int16_t radius,
+             uint8_t tiredHeight, uint8_t angryHeight, uint8_t happyOffset, int16_t happyHeight, bool rightEye);
+
+    // Visible rows of column c (0 = left edge of the eye), top inclusive, bottom exclusive, in screen pixels.
+    // Returns false if nothing of the column is visible.
+    bool column(int16_t c, int16_t& top, int16_t& bottom) const;
+
+    // Write the visible rows of all columns, relative to y, as top/bottom byte pairs (equal if empty)
+    void rasterize(uint8_t* spans) const;
+
+    // Read columns from spans written by rasterize() instead of computing them
+    void useSpans(const uint8_t* spans);
+
+    // True if this shape is other mirrored horizontally. The tired and angry lids of the two eyes
+    // are mirror images, so this holds whenever both eyes share width, height and radius.
+    bool mirrors(const EyeShape& other) const;
+
+    // Read columns back to front from the spans of other, if it is rasterized and mirrors this shape
+    bool useMirrorOf(const EyeShape& other);
+
+    // True if the eye body overlaps columns x0..x1 and rows y0..y1 (exclusive ends)
+    bool overlaps(int16_t x0, int16_t y0, int16_t x1, int16_t y1) const {
+        return width > 0 && height > 0 && x < x1 && x + width > x0 && y < y1 && y + height > y0;
+    }
+
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+    Key_s key;
+
+   private:
+    int16_t happyTop;             // top of the happy lid rect, relative to y
+    const uint8_t* corners;       // corner table row of the body radius
+    const uint8_t* happyCorners;  // and of the happy lid radius
+    const uint8_t* spans = nullptr;
+    bool reversed = false;  // spans belong to the mirrored shape
+
+    bool computeColumn(int16_t c, int16_t& top, int16_t& bottom) const;
+};
+
+// Small LRU cache of rasterized eye shapes. Between blinks the eyes keep returning to a few
+// shapes, a hit turns a frame into plain copies of the cached column spans.
+class EyeShapeCache {
+   public:
+    // Start the shapes of the next frame, spans attached since the last call stay put until the next one
+    void beginFrame();
+
+    // Point shape to its cached spans, rasterizing them on a miss
+    void attach(EyeShape& shape);
+
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+
+#if ROBOEYES_SHAPE_CACHE_SIZE > 0
+   private:
+    struct Entry_s {
+        EyeShape::Key_s key;
+        unsigned long lastUsed;  // frame of the last use, 0 = empty slot
+        uint8_t spans[2 * ROBOEYES_SHAPE_CACHE_WIDTH];
+    };
+    Entry_s entries[ROBOEYES_SHAPE_CACHE_SIZE] = {};
+    unsigned long useCounter = 0;  // current frame
+#endif
+};
+
+// Frame buffer in SSD1306 page order: each byte holds 8 vertical pixels (LSB on top),
+// a page is one row of `width` bytes covering 8 pixel rows.
+class PageRaster {
+   public:
+    PageRaster(uint8_t* buffer, int16_t width, int16_t height);
+
+    // Band of a frame buffer: buffer holds only `pages` pages starting at firstPage
+    PageRaster(uint8_t* buffer, int16_t width, int16_t height, uint8_t firstPage, uint8_t pages);
+
+    // Fill the whole buffer with color
+    void clear(uint8_t color = 0);
+
+    // Render the pages touched by rows y0..y1 and columns x0..x1 (exclusive ends) of both eyes.
+    // Every byte in that window is written exactly once, background included.
+    void composeEyes(const EyeShape& left, const EyeShape& right, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+   private:
+    uint8_t* buffer;
+    int16_t width;
+    int16_t height;
+    uint8_t firstPage = 0;
+    uint8_t pages;
+};
+
+#endif
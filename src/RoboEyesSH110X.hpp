@@ -0,0 +1,45 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Adafruit_SH110X adapter for SH1106G and SH1107 displays.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_SH110X_HPP
+#define _ROBOEYES_SH110X_HPP
+
+#include <Adafruit_SH110X.h>
+
+#include "RoboEyesDisplay.hpp"
+
+inline uint16_t roboEyesFlushSH110X(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+    Adafruit_SH110X& oled = *static_cast<Adafruit_SH110X*>(context);
+    roboEyesCopyWindow(oled.getBuffer(), oled.width(), data, stride, page0, page1, col0, col1);
+
+    // display() only sends the window touched by drawPixel() since the last call.
+    // Redrawing two opposite corners with their own color marks exactly the flushed window.
+    const int16_t y0 = page0 * 8;
+    const int16_t y1 = page1 * 8 + 7;
+    oled.drawPixel(col0, y0, oled.getPixel(col0, y0));
+    oled.drawPixel(col1, y1, oled.getPixel(col1, y1));
+    oled.display();
+    return (page1 - page0 + 1) * (col1 - col0 + 1);
+}
+
+// Draw into the display's own buffer, flushes send only the changed window
+inline RoboEyesDisplay roboEyesDisplay(Adafruit_SH110X& oled) {
+    return {oled.getBuffer(), oled.width(), oled.height(), &oled, roboEyesFlushSH110X, nullptr, false};
+}
+
+#endif
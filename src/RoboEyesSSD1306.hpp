@@ -0,0 +1,61 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Adafruit_SSD1306 adapter, sends only the changed part of a frame over I2C.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_SSD1306_HPP
+#define _ROBOEYES_SSD1306_HPP
+
+#include <Adafruit_SSD1306.h>
+
+#include "RoboEyesDisplay.hpp"
+#include "RoboEyesSSD1306Wire.hpp"
+
+// Adafruit_SSD1306 only offers a full screen display(), its bus handles are protected.
+// Member pointers formed in a derived class can be applied to any Adafruit_SSD1306.
+struct RoboEyesSSD1306Access : Adafruit_SSD1306 {
+    static constexpr TwoWire* Adafruit_SSD1306::*wirePtr() { return &RoboEyesSSD1306Access::wire; }
+    static constexpr int8_t Adafruit_SSD1306::*i2caddrPtr() { return &RoboEyesSSD1306Access::i2caddr; }
+    static constexpr uint32_t Adafruit_SSD1306::*wireClkPtr() { return &RoboEyesSSD1306Access::wireClk; }
+    static constexpr uint32_t Adafruit_SSD1306::*restoreClkPtr() { return &RoboEyesSSD1306Access::restoreClk; }
+};
+
+inline uint16_t roboEyesFlushSSD1306(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+    Adafruit_SSD1306& oled = *static_cast<Adafruit_SSD1306*>(context);
+
+    TwoWire* wire = oled.*RoboEyesSSD1306Access::wirePtr();
+    if (wire == nullptr || (oled.width() == 64 && oled.height() == 48)) {
+        // SPI displays and the column shifted 64x48 panel use the regular full screen transfer
+        roboEyesCopyWindow(oled.getBuffer(), oled.width(), data, stride, page0, page1, col0, col1);
+        oled.display();
+        return oled.width() * ((oled.height() + 7) / 8);
+    }
+
+    const uint8_t address = oled.*RoboEyesSSD1306Access::i2caddrPtr();
+    wire->setClock(oled.*RoboEyesSSD1306Access::wireClkPtr());
+
+    const uint16_t sent = roboEyesSendSSD1306(*wire, address, data, stride, page0, page1, col0, col1);
+
+    wire->setClock(oled.*RoboEyesSSD1306Access::restoreClkPtr());
+    return sent;
+}
+
+// Draw into the display's own buffer, flushes send only the changed window over I2C
+inline RoboEyesDisplay roboEyesDisplay(Adafruit_SSD1306& oled) {
+    return {oled.getBuffer(), oled.width(), oled.height(), &oled, roboEyesFlushSSD1306, nullptr, false};
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * SSD1306 over I2C without a frame buffer, RoboEyes renders and sends one page at a time.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_SSD1306_WIRE_HPP
+#define _ROBOEYES_SSD1306_WIRE_HPP
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "RoboEyesDisplay.hpp"
+
+// Largest I2C transfer the Wire library can buffer, same limits as Adafruit_SSD1306 uses
+#if defined(I2C_BUFFER_LENGTH)
+#define ROBOEYES_WIRE_MAX min(256, I2C_BUFFER_LENGTH)
+#elif defined(BUFFER_LENGTH)
+#define ROBOEYES_WIRE_MAX min(256, BUFFER_LENGTH)
+#elif defined(SERIAL_BUFFER_SIZE)
+#define ROBOEYES_WIRE_MAX min(255, SERIAL_BUFFER_SIZE - 1)
+#else
+#define ROBOEYES_WIRE_MAX 32
+#endif
+
+// Send pages page0..page1, columns col0..col1 of data to an SSD1306 at address
+inline uint16_t roboEyesSendSSD1306(TwoWire& wire, uint8_t address, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+    // Restrict the controller's address window (PAGEADDR, COLUMNADDR), data then wraps inside of it.
+    // The controller has 128 columns and 8 pages, so each fits a command byte.
+    const uint8_t window[] = {0x00, 0x22, (uint8_t)page0, (uint8_t)page1, 0x21, (uint8_t)col0, (uint8_t)col1};
+    wire.beginTransmission(address);
+    wire.write(window, sizeof(window));
+    wire.endTransmission();
+
+    wire.beginTransmission(address);
+    wire.write((uint8_t)0x40);
+    uint16_t bytesOut = 1;
+    for (uint16_t page = page0; page <= page1; page++) {
+        for (uint16_t col = col0; col <= col1; col++) {
+            if (bytesOut >= ROBOEYES_WIRE_MAX) {
+                wire.endTransmission();
+                wire.beginTransmission(address);
+                wire.write((uint8_t)0x40);
+                bytesOut = 1;
+            }
+            wire.write(data[col]);
+            bytesOut++;
+        }
+        data += stride;
+    }
+    wire.endTransmission();
+    return (page1 - page0 + 1) * (col1 - col0 + 1);
+}
+
+// Drives the panel directly, without Adafruit_SSD1306 and its width * height / 8 byte buffer.
+// Only a single page (width bytes) is kept in RAM. For 128x64, 128x32 and 96x16 panels.
+// Call Wire.begin() and begin() first:
+//   RoboEyesSSD1306Wire oled(Wire);
+//   oled.begin();
+//   RoboEyes eyes(128, 64, 50, oled.display());
+class RoboEyesSSD1306Wire {
+   public:
+    RoboEyesSSD1306Wire(TwoWire& wire, uint8_t address = 0x3C, uint8_t width = 128, uint8_t height = 64)
+        : wire(wire),
+          address(address),
+          width(min(width, (uint8_t)128)),
+          height(height) {
+    }
+
+    // Power the panel up with the internal charge pump, same settings as Adafruit_SSD1306.
+    // False if the display doesn't answer.
+    bool begin() {
+        const uint8_t comPins = height == 64 ? 0x12 : 0x02;
+        const uint8_t contrast = height == 64 ? 0xCF : 0x8F;
+        const uint8_t init[] = {
+            0x00,                         // command stream
+            0xAE,                         // display off
+            0xD5, 0x80,                   // clock divide ratio
+            0xA8, (uint8_t)(height - 1),  // multiplex
+            0xD3, 0x00,                   // display offset
+            0x40,                         // start line 0
+            0x8D, 0x14,                   // charge pump on
+            0x20, 0x00,                   // horizontal addressing
+            0xA1, 0xC8,                   // segment remap, COM scan descending
+            0xDA, comPins,                // COM pins
+            0x81, contrast,               // contrast
+            0xD9, 0xF1,                   // precharge
+            0xDB, 0x40,                   // VCOMH deselect
+            0xA4, 0xA6, 0x2E,             // show RAM, not inverted, no scrolling
+            0xAF};                        // display on
+        wire.beginTransmission(address);
+        wire.write(init, sizeof(init));
+        return wire.endTransmission() == 0;
+    }
+
+    // Banded display to construct RoboEyes with
+    RoboEyesDisplay display() {
+        return {band, width, height, this, flush, nullptr, true};
+    }
+
+   private:
+    TwoWire& wire;
+    uint8_t address;
+    uint8_t width;
+    uint8_t height;
+    uint8_t band[128];
+
+    static uint16_t flush(void* context, const uint8_t* data, int16_t stride, uint16_t page0, uint16_t page1, uint16_t col0, uint16_t col1) {
+        RoboEyesSSD1306Wire& self = *static_cast<RoboEyesSSD1306Wire*>(context);
+        return roboEyesSendSSD1306(self.wire, self.address, data, stride, page0, page1, col0, col1);
+    }
+};
+
+#endif
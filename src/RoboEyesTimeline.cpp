@@ -0,0 +1,140 @@
+#include "RoboEyesTimeline.hpp"
+
+RoboEyesTimeline::RoboEyesTimeline(RoboEyes& eyes, const RoboEyesKeyframe* keyframes, uint8_t count, unsigned long loopLength)
+    : eyes(eyes),
+      keyframes(keyframes),
+      count(count),
+      loopLength(loopLength) {
+}
+
+void RoboEyesTimeline::start() {
+    cursor = 0;
+    playing = true;
+    startTime = eyes.getTime();
+}
+
+void RoboEyesTimeline::stop() {
+    playing = false;
+}
+
+void RoboEyesTimeline::update() {
+    if (!playing) {
+        return;
+    }
+    const unsigned long now = eyes.getTime();
+    while (true) {
+        if (cursor == count) {
+            if (loopLength == 0) {
+                playing = false;
+                return;
+            }
+            if (now - startTime < loopLength) {
+                return;
+            }
+            startTime += loopLength;
+            if (now - startTime >= loopLength) {
+                startTime = now - (now - startTime) % loopLength;  // stalled for whole loops, skip them
+            }
+            cursor = 0;
+            continue;
+        }
+        if (now - startTime < keyframes[cursor].at) {
+            return;
+        }
+        run(keyframes[cursor++]);
+    }
+}
+
+unsigned long RoboEyesTimeline::nextDeadline() const {
+    if (!playing) {
+        return eyes.getTime() + 0x7FFFFFFFUL;
+    }
+    if (cursor < count) {
+        return startTime + keyframes[cursor].at;
+    }
+    return loopLength ? startTime + loopLength : eyes.getTime();  // a finished timeline stops with the next update()
+}
+
+void RoboEyesTimeline::run(const RoboEyesKeyframe& keyframe) {
+    const int16_t a = keyframe.a;
+    const int16_t b = keyframe.b;
+    const int16_t c = keyframe.c;
+    switch (keyframe.action) {
+        case KEYFRAME_OPEN:
+            if (a || b) {
+                eyes.open(a, b);
+            } else {
+                eyes.open();
+            }
+            break;
+        case KEYFRAME_CLOSE:
+            if (a || b) {
+                eyes.close(a, b);
+            } else {
+                eyes.close();
+            }
+            break;
+        case KEYFRAME_BLINK:
+            if (a || b) {
+                eyes.blink(a, b);
+            } else {
+                eyes.blink();
+            }
+            break;
+        case KEYFRAME_MOOD:
+            eyes.setMood(a);
+            break;
+        case KEYFRAME_POSITION:
+            eyes.setPosition(a);
+            break;
+        case KEYFRAME_CURIOSITY:
+            eyes.setCuriosity(a);
+            break;
+        case KEYFRAME_AUTOBLINKER:
+            if (b || c) {
+                eyes.setAutoblinker(a, b, c);
+            } else {
+                eyes.setAutoblinker(a);
+            }
+            break;
+        case KEYFRAME_IDLE:
+            if (b || c) {
+                eyes.setIdleMode(a, b, c);
+            } else {
+                eyes.setIdleMode(a);
+            }
+            break;
+        case KEYFRAME_HFLICKER:
+            if (b) {
+                eyes.setHFlicker(a, b);
+            } else {
+                eyes.setHFlicker(a);
+            }
+            break;
+        case KEYFRAME_VFLICKER:
+            if (b) {
+                eyes.setVFlicker(a, b);
+            } else {
+                eyes.setVFlicker(a);
+            }
+            break;
+        case KEYFRAME_WIDTH:
+            eyes.setWidth(a, b);
+            break;
+        case KEYFRAME_HEIGHT:
+            eyes.setHeight(a, b);
+            break;
+        case KEYFRAME_RADIUS:
+            eyes.setBorderradius(a, b);
+            break;
+        case KEYFRAME_SPACE:
+            eyes.setSpacebetween(a);
+            break;
+        case KEYFRAME_LAUGH:
+            eyes.anim_laugh();
+            break;
+        case KEYFRAME_CONFUSED:
+            eyes.anim_confused();
+            break;
+    }
+}
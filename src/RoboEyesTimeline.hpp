@@ -0,0 +1,105 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Plays a fixed table of timestamped commands, once or looped.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_TIMELINE_HPP
+#define _ROBOEYES_TIMELINE_HPP
+
+#include "RoboEyes.hpp"
+
+// Command of a keyframe, a b and c are its arguments
+enum KeyframeAction : uint8_t {
+    KEYFRAME_OPEN,         // open(), or open(a, b) if either is set
+    KEYFRAME_CLOSE,        // close(), or close(a, b) if either is set
+    KEYFRAME_BLINK,        // blink(), or blink(a, b) if either is set
+    KEYFRAME_MOOD,         // setMood(a)
+    KEYFRAME_POSITION,     // setPosition(a)
+    KEYFRAME_CURIOSITY,    // setCuriosity(a)
+    KEYFRAME_AUTOBLINKER,  // setAutoblinker(a, b, c), or setAutoblinker(a) if b and c are 0
+    KEYFRAME_IDLE,         // setIdleMode(a, b, c), or setIdleMode(a) if b and c are 0
+    KEYFRAME_HFLICKER,     // setHFlicker(a, b), or setHFlicker(a) if b is 0
+    KEYFRAME_VFLICKER,     // setVFlicker(a, b), or setVFlicker(a) if b is 0
+    KEYFRAME_WIDTH,        // setWidth(a, b)
+    KEYFRAME_HEIGHT,       // setHeight(a, b)
+    KEYFRAME_RADIUS,       // setBorderradius(a, b)
+    KEYFRAME_SPACE,        // setSpacebetween(a)
+    KEYFRAME_LAUGH,        // anim_laugh()
+    KEYFRAME_CONFUSED,     // anim_confused()
+};
+
+struct RoboEyesKeyframe {
+    constexpr RoboEyesKeyframe(unsigned long at, KeyframeAction action, int16_t a = 0, int16_t b = 0, int16_t c = 0)
+        : at(at), action(action), a(a), b(b), c(c) {
+    }
+
+    unsigned long at;  // milliseconds after the start of the timeline
+    KeyframeAction action;
+    int16_t a;
+    int16_t b;
+    int16_t c;
+};
+
+// Plays keyframes sorted by time, e.g.
+//   static const RoboEyesKeyframe script[] = {
+//       {2000, KEYFRAME_OPEN},
+//       {4000, KEYFRAME_MOOD, MOOD_HAPPY},
+//       {4000, KEYFRAME_LAUGH},
+//       {6000, KEYFRAME_MOOD, MOOD_TIRED},
+//       {8000, KEYFRAME_CLOSE},
+//   };
+//   RoboEyesTimeline timeline(eyes, script, 8000);
+// The table is only read, never copied. A cursor points at the next keyframe, so update()
+// only compares one timestamp unless keyframes are due. Loops restart from the scheduled
+// loop start rather than from the time update() noticed the end, so they don't drift.
+class RoboEyesTimeline {
+   public:
+    // loopLength 0 plays the timeline once, otherwise it restarts every loopLength milliseconds
+    // and all keyframes must be earlier than that
+    RoboEyesTimeline(RoboEyes& eyes, const RoboEyesKeyframe* keyframes, uint8_t count, unsigned long loopLength);
+
+    // Takes the count from the array, loopLength has no default above so the two never mix up
+    template <uint8_t N>
+    RoboEyesTimeline(RoboEyes& eyes, const RoboEyesKeyframe (&keyframes)[N], unsigned long loopLength = 0)
+        : RoboEyesTimeline(eyes, keyframes, N, loopLength) {
+    }
+
+    // Play from the first keyframe, the timeline starts now
+    void start();
+
+    void stop();
+
+    bool isPlaying() const { return playing; }
+
+    // Run the keyframes that are due, call it next to RoboEyes::update()
+    void update();
+
+    // millis() of the next keyframe, or of the next loop start. Far ahead (2^31 ms) when stopped.
+    unsigned long nextDeadline() const;
+
+   private:
+    RoboEyes& eyes;
+    const RoboEyesKeyframe* keyframes;
+    uint8_t count;
+    uint8_t cursor = 0;  // next keyframe to run
+    bool playing = false;
+    unsigned long loopLength;
+    unsigned long startTime = 0;  // of the current loop
+
+    void run(const RoboEyesKeyframe& keyframe);
+};
+
+#endif
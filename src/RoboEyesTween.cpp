@@ -0,0 +1,88 @@
+#include "RoboEyesTween.hpp"
+
+// 2^(-i/16) in Q16, the part of an exponential transition left after i/16 half-lives
+static constexpr uint32_t HALF_LIFE_FRACTIONS[] = {
+    65536, 62757, 60097, 57549, 55109, 52773, 50535, 48393, 46341,
+    44376, 42495, 40693, 38968, 37316, 35734, 34219, 32768};
+
+uint32_t Tween::exponentialRemaining(unsigned long elapsed, unsigned int halfLife) {
+    if (halfLife == 0 || elapsed / halfLife >= 16) {
+        return 0;
+    }
+    const uint8_t halvings = elapsed / halfLife;
+    const uint16_t steps = (elapsed % halfLife) * 256 / halfLife;  // 1/256 half-lives
+    const uint8_t i = steps >> 4;
+    const uint8_t f = steps & 15;
+    const uint32_t remaining = HALF_LIFE_FRACTIONS[i] - ((HALF_LIFE_FRACTIONS[i] - HALF_LIFE_FRACTIONS[i + 1]) * f >> 4);
+    return remaining >> halvings;
+}
+
+// Curves over a fixed number of half-lives, sampled at 64 steps in Q14 (16384 = target reached)
+static constexpr uint8_t CURVE_STEPS = 64;
+
+// 3u^2 - 2u^3 with u = i / 64, over 2 half-lives
+static constexpr int16_t EASE_IN_OUT_CURVE[CURVE_STEPS + 1] = {
+    0, 11, 47, 104, 184, 284, 405, 545, 704, 880, 1075, 1285, 1512,
+    1753, 2009, 2278, 2560, 2853, 3159, 3474, 3800, 4134, 4477, 4827, 5184, 5546,
+    5915, 6287, 6664, 7043, 7425, 7808, 8192, 8575, 8959, 9340, 9720, 10096, 10469,
+    10837, 11200, 11556, 11907, 12249, 12584, 12909, 13225, 13530, 13824, 14105, 14375, 14630,
+    14872, 15098, 15309, 15503, 15680, 15838, 15979, 16099, 16200, 16279, 16337, 16372, 16384};
+
+// Damped spring 1 - e^(-zwt) (cos(w't) + zw/w' sin(w't)) with damping z = 0.5, w chosen to
+// pass the halfway mark after one half-life. Over 8 half-lives, the last sample snapped to 16384.
+static constexpr int16_t SPRING_CURVE[CURVE_STEPS + 1] = {
+    0, 203, 765, 1620, 2704, 3955, 5319, 6746, 8192, 9620, 10997, 12299, 13505,
+    14600, 15574, 16423, 17143, 17738, 18212, 18570, 18823, 18979, 19049, 19044, 18976, 18856,
+    18694, 18500, 18285, 18055, 17820, 17585, 17357, 17139, 16935, 16749, 16581, 16434, 16308,
+    16202, 16117, 16050, 16002, 15970, 15953, 15949, 15956, 15972, 15995, 16025, 16059, 16095,
+    16133, 16172, 16210, 16246, 16280, 16312, 16341, 16366, 16388, 16407, 16422, 16434, 16384};
+
+int32_t Tween::advance(int current, int target, unsigned long elapsed, unsigned int halfLife, Easing easing) {
+    const int32_t end = (int32_t)target * 256;
+
+    // Changed from outside, e.g. by flicker offsets: carry on from there
+    if (((value + 128) >> 8) != current) {
+        const int32_t moved = (int32_t)current * 256 - value;
+        value += moved;
+        from += moved;
+        if (progress == DONE) {
+            from = value;
+            progress = from == end ? DONE : 0;
+        }
+    }
+    if (target != to) {
+        to = target;
+        from = value;
+        progress = from == end ? DONE : 0;
+    }
+
+    if (easing == EASE_EXPONENTIAL) {
+        progress = DONE;
+        const uint32_t remaining = exponentialRemaining(elapsed, halfLife);
+        int32_t next = end + ((value - end) * (int32_t)(remaining >> 4) >> 12);
+        if (next - end < 128 && end - next < 128) {
+            next = end;  // within half a pixel, land on the target instead of creeping towards it
+        }
+        return next;
+    }
+
+    if (progress == DONE) {
+        return end;
+    }
+    uint32_t span = (uint32_t)halfLife * (easing == EASE_IN_OUT ? 2 : 8);
+    if (span >= DONE) {
+        span = DONE - 1;
+    }
+    if (elapsed >= span - progress) {
+        progress = DONE;
+        return end;
+    }
+    progress += elapsed;
+
+    const uint32_t q = (uint32_t)progress * (CURVE_STEPS * 256) / span;  // 1/256 curve steps
+    const int16_t* curve = easing == EASE_IN_OUT ? EASE_IN_OUT_CURVE : SPRING_CURVE;
+    const uint8_t i = q >> 8;
+    const int32_t f = q & 255;
+    const int32_t c = curve[i] + ((curve[i + 1] - curve[i]) * f >> 8);
+    return from + ((end - from) * (c >> 4) >> 10);
+}
@@ -0,0 +1,66 @@
+/*
+ * FORK of RoboEyes for OLED Displays V 0.0.1
+ * Fixed point transitions with easing curves, without floating point math.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROBOEYES_TWEEN_HPP
+#define _ROBOEYES_TWEEN_HPP
+
+#include <stdint.h>
+
+// Shape of a transition, all of them pass the halfway mark after one half-life
+enum Easing : uint8_t {
+    EASE_EXPONENTIAL,  // fast start, slows down towards the target
+    EASE_IN_OUT,       // smoothstep, arrives after two half-lives
+    EASE_SPRING,       // overshoots by about 16% and swings back, arrives after eight half-lives
+};
+
+// Sub-pixel state of one animated value. The value itself stays a plain integer field that the
+// rest of RoboEyes reads and may change, step() picks such changes up and writes it back rounded.
+class Tween {
+   public:
+    static constexpr int16_t UNBOUNDED = INT16_MIN;  // for values that may go negative
+
+    // Move current towards target by elapsed milliseconds. Values land exactly on the target and
+    // never go below lowest. Returns true while the value is still moving, even by less than a pixel.
+    template <class T>
+    bool step(T& current, T target, unsigned long elapsed, unsigned int halfLife, Easing easing, int16_t lowest = 0) {
+        const uint16_t lastProgress = progress;
+        int32_t value = advance((int)current, (int)target, elapsed, halfLife, easing);
+        if (value < (int32_t)lowest * 256) {
+            value = (int32_t)lowest * 256;
+        }
+        const bool moving = value != this->value || progress != lastProgress;
+        this->value = value;
+        current = (T)((value + 128) >> 8);
+        return moving;
+    }
+
+    // Part of an exponential transition left after elapsed milliseconds, in Q16
+    static uint32_t exponentialRemaining(unsigned long elapsed, unsigned int halfLife);
+
+   private:
+    static constexpr uint16_t DONE = 0xFFFF;  // progress of a finished curve
+
+    int32_t value = 0;   // 1/256 pixels
+    int32_t from = 0;    // start of the running curve, 1/256 pixels
+    int16_t to = 0;      // target of the running curve
+    uint16_t progress = DONE;  // milliseconds into the running curve
+
+    int32_t advance(int current, int target, unsigned long elapsed, unsigned int halfLife, Easing easing);
+};
+
+#endif